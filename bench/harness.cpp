@@ -40,6 +40,48 @@ static bool RunBenchmark(std::function<void()> setupFn,
     return true;
 }
 
+//-----------------------------------------------------------------------------
+// Random patches and curves of every degree, always the same ones, and the
+// parameters at which to evaluate them.
+//-----------------------------------------------------------------------------
+static void MakeRandomPatches(std::vector<SSurface> *srfs,
+                              std::vector<SBezier> *curves,
+                              std::vector<Point2d> *params) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(-100, 100), weight(0.5, 2.0),
+                                           param(0, 1);
+
+    for(int degm = 1; degm <= 3; degm++) {
+        for(int degn = 1; degn <= 3; degn++) {
+            for(int rational = 0; rational < 2; rational++) {
+                SSurface srf = {};
+                srf.degm = degm;
+                srf.degn = degn;
+                for(int i = 0; i <= degm; i++) {
+                    for(int j = 0; j <= degn; j++) {
+                        srf.ctrl[i][j] = Vector::From(coord(rng), coord(rng), coord(rng));
+                        srf.weight[i][j] = rational ? weight(rng) : 1.0;
+                    }
+                }
+                srfs->push_back(srf);
+            }
+        }
+        for(int rational = 0; rational < 2; rational++) {
+            SBezier sb = {};
+            sb.deg = degm;
+            for(int i = 0; i <= degm; i++) {
+                sb.ctrl[i] = Vector::From(coord(rng), coord(rng), coord(rng));
+                sb.weight[i] = rational ? weight(rng) : 1.0;
+            }
+            curves->push_back(sb);
+        }
+    }
+
+    for(int i = 0; i < 4096; i++) {
+        params->push_back(Point2d::From(param(rng), param(rng)));
+    }
+}
+
 int main(int argc, char **argv) {
     std::vector<std::string> args = InitPlatform(argc, argv);
 
@@ -48,9 +90,11 @@ int main(int argc, char **argv) {
     if(args.size() == 3) {
         mode = args[1];
         filename = Platform::Path::From(args[2]);
+    } else if(args.size() == 2 && args[1] == "eval") {
+        mode = args[1];
     } else {
         fprintf(stderr, "Usage: %s [mode] [filename]\n", args[0].c_str());
-        fprintf(stderr, "Mode can be one of: load.\n");
+        fprintf(stderr, "Mode can be one of: load, eval (without a filename).\n");
         return 1;
     }
 
@@ -70,6 +114,36 @@ int main(int argc, char **argv) {
                 SK.Clear();
                 SS.Clear();
             });
+    } else if(mode == "eval") {
+        // Evaluate points and tangents on surfaces and curves, as when
+        // triangulating, projecting points, and intersecting.
+        std::vector<SSurface> srfs;
+        std::vector<SBezier> curves;
+        std::vector<Point2d> params;
+        MakeRandomPatches(&srfs, &curves, &params);
+
+        result = RunBenchmark(
+            [] {},
+            [&] {
+                Vector sum = Vector::From(0, 0, 0);
+                for(int pass = 0; pass < 50; pass++) {
+                    for(const SSurface &srf : srfs) {
+                        for(Point2d uv : params) {
+                            Vector tu, tv;
+                            srf.TangentsAt(uv.x, uv.y, &tu, &tv);
+                            sum = sum.Plus(srf.PointAt(uv)).Plus(tu).Plus(tv);
+                        }
+                    }
+                    for(const SBezier &sb : curves) {
+                        for(Point2d uv : params) {
+                            sum = sum.Plus(sb.PointAt(uv.x)).Plus(sb.TangentAt(uv.x));
+                        }
+                    }
+                }
+                // So that none of that can be optimized out.
+                return !sum.Equals(Vector::From(VERY_POSITIVE, 0, 0));
+            },
+            [] {});
     } else {
         fprintf(stderr, "Unknown mode \"%s\"\n", mode.c_str());
     }
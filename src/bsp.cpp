@@ -457,6 +457,22 @@ SBsp3 *SBsp3::InsertOrCreate(SBsp3 *where, STriangle *tr, SMesh *instead) {
     return where;
 }
 
+//-----------------------------------------------------------------------------
+// Is the point outside (POS) or inside (NEG) the volume? If it lies in the
+// plane of some node on the way down then we can't tell without working out
+// which face it's on, so we just say COPLANAR and let the caller do that.
+//-----------------------------------------------------------------------------
+BspClass SBsp3::ClassifyPoint(Vector p) const {
+    double dp = p.Dot(n) - d;
+    if(dp > LENGTH_EPS) {
+        return pos ? pos->ClassifyPoint(p) : BspClass::POS;
+    } else if(dp < -LENGTH_EPS) {
+        return neg ? neg->ClassifyPoint(p) : BspClass::NEG;
+    } else {
+        return BspClass::COPLANAR;
+    }
+}
+
 void SBsp3::Insert(STriangle *tr, SMesh *instead) {
     BspUtil *u = BspUtil::Alloc();
     u->ClassifyTriangle(tr, this);
@@ -166,6 +166,11 @@ void TextWindow::ScreenChangeAutosaveInterval(int link, uint32_t v) {
     SS.TW.edit.meaning = Edit::AUTOSAVE_INTERVAL;
 }
 
+void TextWindow::ScreenChangeGenerateTimeLimit(int link, uint32_t v) {
+    SS.TW.ShowEditControl(3, std::to_string(SS.generateTimeLimit));
+    SS.TW.edit.meaning = Edit::GENERATE_TIME_LIMIT;
+}
+
 void TextWindow::ShowConfiguration() {
     int i;
     Printf(true, "%Ft user color (r, g, b)");
@@ -196,7 +201,7 @@ void TextWindow::ShowConfiguration() {
     Printf(false, "%Ba   %@ %% %Fl%Ll%f%D[change]%E; %@ mm, %d triangles",
         SS.chordTol,
         &ScreenChangeChordTolerance, 0, SS.chordTolCalculated,
-        SK.GetGroup(SS.GW.activeGroup)->displayMesh.l.n);
+        SK.GetGroup(SS.GW.activeGroup)->DisplayMesh()->l.n);
     Printf(false, "%Ft max piecewise linear segments%E");
     Printf(false, "%Ba   %d %Fl%Ll%f[change]%E",
         SS.maxSegments,
@@ -311,6 +316,12 @@ void TextWindow::ShowConfiguration() {
     Printf(false, "%Ba   %d %Fl%Ll%f[change]%E",
         SS.autosaveInterval, &ScreenChangeAutosaveInterval);
 
+    Printf(false, "");
+    Printf(false, "%Ft time limit to regenerate after an edit%E");
+    Printf(false, "%Ft (in seconds, or 0 for none)%E");
+    Printf(false, "%Ba   %d %Fl%Ll%f[change]%E",
+        SS.generateTimeLimit, &ScreenChangeGenerateTimeLimit);
+
     if(canvas) {
         const char *gl_vendor, *gl_renderer, *gl_version;
         canvas->GetIdent(&gl_vendor, &gl_renderer, &gl_version);
@@ -468,6 +479,19 @@ bool TextWindow::EditControlDoneForConfiguration(const char *s) {
             }
             break;
         }
+        case Edit::GENERATE_TIME_LIMIT: {
+            int limit;
+            if(sscanf(s, "%d", &limit)==1) {
+                if(limit >= 0) {
+                    SS.generateTimeLimit = limit;
+                } else {
+                    Error(_("Bad value: time limit should not be negative"));
+                }
+            } else {
+                Error(_("Bad format: specify time limit in integral seconds"));
+            }
+            break;
+        }
 
         default: return false;
     }
@@ -444,7 +444,7 @@ void GraphicsWindow::HitTestMakeSelection(Point2d mp) {
         // Faces, from the triangle mesh; these are lowest priority
         if(sel.constraint.v == 0 && sel.entity.v == 0 && showShaded && showFaces) {
             Group *g = SK.GetGroup(activeGroup);
-            SMesh *m = &(g->displayMesh);
+            SMesh *m = g->DisplayMesh();
 
             uint32_t v = m->FirstIntersectionWith(mp);
             if(v) {
@@ -638,7 +638,17 @@ void GraphicsWindow::DrawEntities(Canvas *canvas, bool persistent) {
 
 void GraphicsWindow::DrawPersistent(Canvas *canvas) {
     // Draw the active group; this does stuff like the mesh and edges.
-    SK.GetGroup(activeGroup)->Draw(canvas);
+    Group *active = SK.GetGroup(activeGroup);
+    active->Draw(canvas);
+
+    // That's the only solid model that we draw, so free any display items
+    // that other groups built when they were active.
+    Group *shown = active->DisplayItemsGroup();
+    for(Group &g : SK.group) {
+        if(&g == shown) continue;
+        if(g.displayMesh.IsEmpty() && g.displayOutlines.l.n == 0) continue;
+        g.ClearDisplayItems();
+    }
 
     // Now draw the entities that don't change with viewport.
     DrawEntities(canvas, /*persistent=*/true);
@@ -14,7 +14,7 @@ void SolveSpaceUI::ExportSectionTo(const Platform::Path &filename) {
 
     Group *g = SK.GetGroup(SS.GW.activeGroup);
     g->GenerateDisplayItems();
-    if(g->displayMesh.IsEmpty()) {
+    if(g->DisplayMesh()->IsEmpty()) {
         Error(_("No solid model present; draw one with extrudes and revolves, "
                 "or use Export 2d View to export bare lines and curves."));
         return;
@@ -180,7 +180,7 @@ void SolveSpaceUI::ExportViewOrWireframeTo(const Platform::Path &filename, bool
     if(SS.GW.showShaded || SS.GW.drawOccludedAs != GraphicsWindow::DrawOccludedAs::VISIBLE) {
         Group *g = SK.GetGroup(SS.GW.activeGroup);
         g->GenerateDisplayItems();
-        sm = &(g->displayMesh);
+        sm = g->DisplayMesh();
     }
     if(sm && sm->IsEmpty()) {
         sm = NULL;
@@ -206,7 +206,7 @@ void SolveSpaceUI::ExportViewOrWireframeTo(const Platform::Path &filename, bool
         Group *g = SK.GetGroup(SS.GW.activeGroup);
         g->GenerateDisplayItems();
         if(SS.GW.showEdges) {
-            g->displayOutlines.ListTaggedInto(&edges, Style::SOLID_EDGE);
+            g->DisplayOutlines()->ListTaggedInto(&edges, Style::SOLID_EDGE);
         }
     }
 
@@ -800,7 +800,7 @@ void SolveSpaceUI::ExportMeshTo(const Platform::Path &filename) {
     Group *g = SK.GetGroup(SS.GW.activeGroup);
     g->GenerateDisplayItems();
 
-    SMesh *m = &(SK.GetGroup(SS.GW.activeGroup)->displayMesh);
+    SMesh *m = g->DisplayMesh();
     if(m->IsEmpty()) {
         Error(_("Active group mesh is empty; nothing to export."));
         return;
@@ -828,7 +828,7 @@ void SolveSpaceUI::ExportMeshTo(const Platform::Path &filename) {
         fclose(fMtl);
     } else if(filename.HasExtension("js") ||
               filename.HasExtension("html")) {
-        SOutlineList *e = &(SK.GetGroup(SS.GW.activeGroup)->displayOutlines);
+        SOutlineList *e = g->DisplayOutlines();
         ExportMeshAsThreeJsTo(f, filename, m, e);
     } else {
         Error("Can't identify output file type from file extension of "
@@ -882,8 +882,12 @@ void SolveSpaceUI::ExportMeshAsStlTo(FILE *f, SMesh *sm) {
 // identical vertices to the same identifier, so do that first.
 //-----------------------------------------------------------------------------
 void SolveSpaceUI::ExportMeshAsObjTo(FILE *fObj, FILE *fMtl, SMesh *sm) {
+    // Write each vertex and normal once, however many triangles share it.
+    SIndexedTriMesh im = {};
+    im.MakeFromMesh(sm);
+
     std::map<RgbaColor, std::string, RgbaColorCompare> colors;
-    for(const STriangle &t : sm->l) {
+    for(const SIndexedTriMesh::Triangle &t : im.triangle) {
         RgbaColor color = t.meta.color;
         if(colors.find(color) == colors.end()) {
             std::string id = ssprintf("h%02x%02x%02x",
@@ -892,10 +896,10 @@ void SolveSpaceUI::ExportMeshAsObjTo(FILE *fObj, FILE *fMtl, SMesh *sm) {
                                       color.blue);
             colors.emplace(color, id);
         }
-        for(int i = 0; i < 3; i++) {
-            fprintf(fObj, "v %.10f %.10f %.10f\n",
-                    CO(t.vertices[i].ScaledBy(1 / SS.exportScale)));
-        }
+    }
+    for(const Vector &v : im.vertex) {
+        fprintf(fObj, "v %.10f %.10f %.10f\n",
+                CO(v.ScaledBy(1 / SS.exportScale)));
     }
 
     for(auto &it : colors) {
@@ -905,27 +909,26 @@ void SolveSpaceUI::ExportMeshAsObjTo(FILE *fObj, FILE *fMtl, SMesh *sm) {
                 it.first.redF(), it.first.greenF(), it.first.blueF());
     }
 
-    for(const STriangle &t : sm->l) {
-        for(int i = 0; i < 3; i++) {
-            Vector n = t.normals[i].WithMagnitude(1.0);
-            fprintf(fObj, "vn %.10f %.10f %.10f\n",
-                    CO(n));
-        }
+    for(const Vector &vn : im.normal) {
+        Vector n = vn.WithMagnitude(1.0);
+        fprintf(fObj, "vn %.10f %.10f %.10f\n",
+                CO(n));
     }
 
     RgbaColor currentColor = {};
-    for(int i = 0; i < sm->l.n; i++) {
-        const STriangle &t = sm->l.elem[i];
+    for(const SIndexedTriMesh::Triangle &t : im.triangle) {
         if(!currentColor.Equals(t.meta.color)) {
             currentColor = t.meta.color;
             fprintf(fObj, "usemtl %s\n", colors[currentColor].c_str());
         }
 
         fprintf(fObj, "f %d//%d %d//%d %d//%d\n",
-                i * 3 + 1, i * 3 + 1,
-                i * 3 + 2, i * 3 + 2,
-                i * 3 + 3, i * 3 + 3);
+                t.vertex[0] + 1, t.normal[0] + 1,
+                t.vertex[1] + 1, t.normal[1] + 1,
+                t.vertex[2] + 1, t.normal[2] + 1);
     }
+
+    im.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -934,7 +937,7 @@ void SolveSpaceUI::ExportMeshAsObjTo(FILE *fObj, FILE *fMtl, SMesh *sm) {
 void SolveSpaceUI::ExportMeshAsThreeJsTo(FILE *f, const Platform::Path &filename,
                                          SMesh *sm, SOutlineList *sol)
 {
-    SPointList spl = {};
+    SIndexedTriMesh im = {};
     STriangle *tr;
     Vector bndl, bndh;
     const char htmlbegin[] = R"(
@@ -1030,32 +1033,25 @@ void SolveSpaceUI::ExportMeshAsThreeJsTo(FILE *f, const Platform::Path &filename
     fprintf(f, "    ],\n"
                "    a: %f\n", SS.ambientIntensity);
 
-    for(tr = sm->l.First(); tr; tr = sm->l.NextAfter(tr)) {
-        spl.IncrementTagFor(tr->a);
-        spl.IncrementTagFor(tr->b);
-        spl.IncrementTagFor(tr->c);
-    }
+    im.MakeFromMesh(sm);
 
     // Output all the vertices.
-    SPoint *sp;
     fputs("  },\n"
           "  points: [\n", f);
-    for(sp = spl.l.First(); sp; sp = spl.l.NextAfter(sp)) {
+    for(const Vector &p : im.vertex) {
         fprintf(f, "    [%f, %f, %f],\n",
-                sp->p.x / SS.exportScale,
-                sp->p.y / SS.exportScale,
-                sp->p.z / SS.exportScale);
+                p.x / SS.exportScale,
+                p.y / SS.exportScale,
+                p.z / SS.exportScale);
     }
 
     fputs("  ],\n"
           "  faces: [\n", f);
     // And now all the triangular faces, in terms of those vertices.
     // This time we count from zero.
-    for(tr = sm->l.First(); tr; tr = sm->l.NextAfter(tr)) {
+    for(const SIndexedTriMesh::Triangle &t : im.triangle) {
         fprintf(f, "    [%d, %d, %d],\n",
-                spl.IndexForPoint(tr->a),
-                spl.IndexForPoint(tr->b),
-                spl.IndexForPoint(tr->c));
+                t.vertex[0], t.vertex[1], t.vertex[2]);
     }
 
     // Output face normals.
@@ -1098,7 +1094,7 @@ void SolveSpaceUI::ExportMeshAsThreeJsTo(FILE *f, const Platform::Path &filename
                 CO(SS.GW.projRight));
     }
 
-    spl.Clear();
+    im.Clear();
 }
 
 //-----------------------------------------------------------------------------
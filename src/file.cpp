@@ -35,6 +35,8 @@ void SolveSpaceUI::ClearExisting() {
     SK.entity.Clear();
     SK.param.Clear();
     images.clear();
+
+    GeometryCacheBase::ClearAll();
 }
 
 hGroup SolveSpaceUI::CreateDefaultDrawingGroup() {
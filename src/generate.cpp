@@ -138,11 +138,35 @@ bool SolveSpaceUI::PruneConstraints(hGroup hg) {
     return false;
 }
 
+//-----------------------------------------------------------------------------
+// Has the regeneration in progress run out of time? Once it has, it stays
+// that way until the next one starts. This may be called from the threads of
+// a Boolean.
+//-----------------------------------------------------------------------------
+bool SolveSpaceUI::IsGenerateCancelled() {
+    if(generateCancelled) return true;
+    if(generateDeadline != 0 && GetMilliseconds() > generateDeadline) {
+        generateCancelled = true;
+    }
+    return generateCancelled;
+}
+
 void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox) {
     int first = 0, last = 0, i, j;
 
     uint64_t startMillis = GetMilliseconds(),
              endMillis;
+    bspStats = {};
+
+    // Only a regeneration of the dirty groups, as after an edit, gets a time
+    // limit; one that was asked for explicitly always runs to completion.
+    if(!genForBBox) {
+        generateCancelled = false;
+        generateDeadline = 0;
+        if(type == Generate::DIRTY && generateTimeLimit > 0) {
+            generateDeadline = (int64_t)startMillis + 1000*(int64_t)generateTimeLimit;
+        }
+    }
 
     SK.groupOrder.Clear();
     for(int i = 0; i < SK.group.n; i++)
@@ -216,10 +240,15 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
     while(PruneOrphans())
         ;
 
-    // Don't lose our numerical guesses when we regenerate.
+    // Don't lose our numerical guesses when we regenerate. Moving the table
+    // is just a pointer swap; the new params get looked up in the old table
+    // just once, when they're first generated, and their tag records whether
+    // they were found there, so we never have to search it again.
+    enum { PARAM_UNSEEN = 0, PARAM_NEW = 1, PARAM_FROM_PREV = 2 };
     IdList<Param,hParam> prev = {};
     SK.param.MoveSelfInto(&prev);
     SK.param.ReserveMore(prev.n);
+    int seenParams = 0;
     int oldEntityCount = SK.entity.n;
     SK.entity.Clear();
     SK.entity.ReserveMore(oldEntityCount);
@@ -254,15 +283,21 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
 
         // Use the previous values for params that we've seen before, as
         // initial guesses for the solver.
-        for(j = 0; j < SK.param.n; j++) {
+        for(j = 0; j < SK.param.n && seenParams < SK.param.n; j++) {
             Param *newp = &(SK.param.elem[j]);
-            if(newp->known) continue;
+            if(newp->tag != PARAM_UNSEEN) continue;
+            seenParams++;
 
             Param *prevp = prev.FindByIdNoOops(newp->h);
-            if(prevp) {
-                newp->val = prevp->val;
-                newp->free = prevp->free;
+            if(!prevp) {
+                newp->tag = PARAM_NEW;
+                continue;
             }
+            newp->tag = PARAM_FROM_PREV;
+            if(newp->known) continue;
+
+            newp->val = prevp->val;
+            newp->free = prevp->free;
         }
 
         if(g->h.v == Group::HGROUP_REFERENCES.v) {
@@ -276,9 +311,11 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
                 if(genForBBox) {
                     SolveGroupAndReport(g->h, andFindFree);
                     g->GenerateLoops();
-                } else {
+                } else if(!IsGenerateCancelled()) {
                     g->GenerateShellAndMesh();
-                    g->clean = true;
+                    // If we ran out of time partway through, then the group
+                    // kept its old shell, and must be regenerated next time.
+                    if(!IsGenerateCancelled()) g->clean = true;
                 }
             } else {
                 // The group falls outside the range, so just assume that
@@ -286,9 +323,7 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
                 // and the parameters must be marked as known.
                 for(j = 0; j < SK.param.n; j++) {
                     Param *newp = &(SK.param.elem[j]);
-
-                    Param *prevp = prev.FindByIdNoOops(newp->h);
-                    if(prevp) newp->known = true;
+                    if(newp->tag == PARAM_FROM_PREV) newp->known = true;
                 }
             }
         }
@@ -361,6 +396,20 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
     SS.GW.persistentDirty = true;
     SS.centerOfMass.dirty = true;
 
+    if(!genForBBox) {
+        bool cancelled = generateCancelled;
+        if(cancelled) {
+            dbp("Generate stopped after %d s; solid model is out of date",
+                generateTimeLimit);
+        }
+        if(cancelled != lastGenerateCancelled) ScheduleShowTW();
+        lastGenerateCancelled = cancelled;
+
+        // Anything else that runs a Boolean, like an export, isn't limited.
+        generateDeadline = 0;
+        generateCancelled = false;
+    }
+
     endMillis = GetMilliseconds();
 
     if(endMillis - startMillis > 30) {
@@ -376,6 +425,10 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
             typeStr,
             (genForBBox ? " (for bounding box)" : ""),
             GetMilliseconds() - startMillis);
+        if(bspStats.nodes > 0) {
+            dbp("    classifying BSPs: %d nodes, max depth %d",
+                bspStats.nodes, bspStats.maxDepth);
+        }
     }
 
     return;
@@ -420,7 +473,7 @@ void SolveSpaceUI::ForceReferences() {
 }
 
 void SolveSpaceUI::UpdateCenterOfMass() {
-    SMesh *m = &(SK.GetGroup(SS.GW.activeGroup)->displayMesh);
+    SMesh *m = SK.GetGroup(SS.GW.activeGroup)->DisplayMesh();
     SS.centerOfMass.position = m->GetCenterOfMass();
     SS.centerOfMass.dirty = false;
 }
@@ -378,8 +378,9 @@ void GraphicsWindow::LoopOverPoints(const std::vector<Entity *> &entities,
 
     Group *g = SK.GetGroup(activeGroup);
     g->GenerateDisplayItems();
-    for(int i = 0; i < g->displayMesh.l.n; i++) {
-        STriangle *tr = &(g->displayMesh.l.elem[i]);
+    SMesh *m = g->DisplayMesh();
+    for(int i = 0; i < m->l.n; i++) {
+        STriangle *tr = &(m->l.elem[i]);
         if(!includeMesh) {
             bool found = false;
             for(const hEntity &face : faces) {
@@ -1094,12 +1095,9 @@ void GraphicsWindow::ToggleBool(bool *v) {
     // so not meaningful to show them and hide the shaded.
     if(!showShaded) showFaces = false;
 
-    // If the mesh or edges were previously hidden, they haven't been generated,
-    // and if we are going to show them, we need to generate them first.
-    Group *g = SK.GetGroup(SS.GW.activeGroup);
-    if(*v && (g->displayOutlines.l.n == 0 && (v == &showEdges || v == &showOutlines))) {
-        SS.GenerateAll(SolveSpaceUI::Generate::UNTIL_ACTIVE);
-    }
+    // If the edges were previously hidden, they haven't been generated; but
+    // that happens lazily when the group is next drawn, so no need to
+    // regenerate anything here.
 
     SS.GW.persistentDirty = true;
     InvalidateGraphics();
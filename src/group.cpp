@@ -25,6 +25,7 @@ void Group::Clear() {
     runningMesh.Clear();
     thisShell.Clear();
     runningShell.Clear();
+    shellMeshKey = 0;
     displayMesh.Clear();
     displayOutlines.Clear();
     impMesh.Clear();
@@ -32,6 +33,7 @@ void Group::Clear() {
     impEntity.Clear();
     // remap is the only one that doesn't get recreated when we regen
     remap.Clear();
+    remapCache.clear();
 }
 
 void Group::AddParam(IdList<Param,hParam> *param, hParam hp, double v) {
@@ -642,29 +644,30 @@ void Group::GenerateEquations(IdList<Equation,hEquation> *l) {
 }
 
 hEntity Group::Remap(hEntity in, int copyNumber) {
-    // A hash table is used to accelerate the search
-    int hash = ((unsigned)(in.v*61 + copyNumber)) % REMAP_PRIME;
-    int i = remapCache[hash];
-    if(i >= 0 && i < remap.n) {
-        EntityMap *em = &(remap.elem[i]);
-        if(em->input.v == in.v && em->copyNumber == copyNumber) {
-            return h.entity(em->h.v);
+    // A hash table is used to accelerate the search. If it doesn't match up
+    // with the list (e.g., because we just loaded the list from a file),
+    // then rebuild it.
+    if(remapCache.size() != (size_t)remap.n) {
+        remapCache.clear();
+        for(const EntityMap &em : remap) {
+            remapCache.emplace(EntityKey { em.input, em.copyNumber }, em.h);
         }
     }
-    // but if we don't find it in the hash table, then linear search
-    for(i = 0; i < remap.n; i++) {
-        EntityMap *em = &(remap.elem[i]);
-        if(em->input.v == in.v && em->copyNumber == copyNumber) {
-            // We already have a mapping for this entity.
-            remapCache[hash] = i;
-            return h.entity(em->h.v);
-        }
+
+    EntityKey key = { in, copyNumber };
+    auto it = remapCache.find(key);
+    if(it != remapCache.end()) {
+        // We already have a mapping for this entity.
+        return h.entity(it->second.v);
     }
-    // And if we still don't find it, then create a new entry.
-    EntityMap em;
+
+    // And if we don't find it, then create a new entry. The ids get assigned
+    // in order of first use, same as always, so saved files don't change.
+    EntityMap em = {};
     em.input = in;
     em.copyNumber = copyNumber;
     remap.AddAndAssignId(&em);
+    remapCache.emplace(key, em.h);
     return h.entity(em.h.v);
 }
 
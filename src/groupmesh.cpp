@@ -115,6 +115,8 @@ void Group::GenerateForStepAndRepeat(T *steps, T *outs, Group::CombineAs forWhat
     }
     int a;
     for(a = a0; a < n; a++) {
+        if(SS.IsGenerateCancelled()) break;
+
         int ap = a*2 - (subtype == Subtype::ONE_SIDED ? 0 : (n-1));
         int remap = (a == (n - 1)) ? REMAP_LAST : a;
 
@@ -177,16 +179,282 @@ void Group::GenerateForBoolean(T *prevs, T *thiss, T *outs, Group::CombineAs how
     }
 }
 
+//-----------------------------------------------------------------------------
+// A running hash (64-bit FNV-1a) over the inputs to GenerateShellAndMesh. We
+// hash the exact bits of the numbers; anything that differs even in the last
+// place just costs us a regeneration.
+//-----------------------------------------------------------------------------
+class ShellMeshHasher {
+public:
+    uint64_t v;
+
+    ShellMeshHasher() : v(14695981039346656037ULL) {}
+
+    void AddBytes(const void *p, size_t n) {
+        const uint8_t *b = (const uint8_t *)p;
+        for(size_t i = 0; i < n; i++) {
+            v ^= b[i];
+            v *= 1099511628211ULL;
+        }
+    }
+    void Add(uint32_t x) { AddBytes(&x, sizeof(x)); }
+    void Add(uint64_t x) { AddBytes(&x, sizeof(x)); }
+    void Add(double d)   { AddBytes(&d, sizeof(d)); }
+    void Add(bool b)     { Add((uint32_t)b); }
+    void Add(int x)      { Add((uint32_t)x); }
+    void Add(Vector p)   { Add(p.x); Add(p.y); Add(p.z); }
+    void Add(RgbaColor c) { Add(c.ToPackedInt()); }
+
+    void Add(const SBezier &sb) {
+        Add(sb.deg);
+        Add(sb.entity);
+        for(int i = 0; i <= sb.deg; i++) {
+            Add(sb.ctrl[i]);
+            Add(sb.weight[i]);
+        }
+    }
+    void Add(const SBezierLoopSetSet &sblss) {
+        Add(sblss.l.n);
+        for(const SBezierLoopSet &sbls : sblss.l) {
+            Add(sbls.normal);
+            Add(sbls.point);
+            Add(sbls.l.n);
+            for(const SBezierLoop &sbl : sbls.l) {
+                Add(sbl.l.n);
+                for(const SBezier &sb : sbl.l) {
+                    Add(sb);
+                }
+            }
+        }
+    }
+    void Add(const SShell &sh) {
+        Add(sh.surface.n);
+        for(const SSurface &ss : sh.surface) {
+            Add(ss.h.v);
+            Add(ss.color);
+            Add(ss.face);
+            Add(ss.degm);
+            Add(ss.degn);
+            for(int i = 0; i <= ss.degm; i++) {
+                for(int j = 0; j <= ss.degn; j++) {
+                    Add(ss.ctrl[i][j]);
+                    Add(ss.weight[i][j]);
+                }
+            }
+            Add(ss.trim.n);
+            for(const STrimBy &stb : ss.trim) {
+                Add(stb.curve.v);
+                Add(stb.backwards);
+                Add(stb.start);
+                Add(stb.finish);
+            }
+        }
+        Add(sh.curve.n);
+        for(const SCurve &sc : sh.curve) {
+            Add(sc.h.v);
+            Add(sc.isExact);
+            if(sc.isExact) Add(sc.exact);
+            Add(sc.surfA.v);
+            Add(sc.surfB.v);
+            Add(sc.pts.n);
+            for(const SCurvePt &scp : sc.pts) {
+                Add(scp.p);
+                Add(scp.vertex);
+            }
+        }
+    }
+    void Add(const SMesh &m) {
+        Add(m.l.n);
+        for(const STriangle &tr : m.l) {
+            Add(tr.meta.face);
+            Add(tr.meta.color);
+            for(int i = 0; i < 3; i++) {
+                Add(tr.vertices[i]);
+                Add(tr.normals[i]);
+            }
+        }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Compute a key for everything that our shell and mesh depend on: our own
+// parameters and options, the loops that we extrude or lathe, the chord
+// tolerance, and the keys of the groups whose shells we consume. Since the
+// predecessor's key stands in for its running shell, a change anywhere
+// upstream propagates down the chain.
+//-----------------------------------------------------------------------------
+uint64_t Group::ComputeShellMeshKey() {
+    ShellMeshHasher hash;
+
+    Group *srcg = this;
+    if(type == Type::TRANSLATE || type == Type::ROTATE) {
+        srcg = SK.GetGroup(opA);
+        hash.Add(srcg->shellMeshKey);
+        hash.Add(srcg->suppress);
+        hash.Add(valA);
+        hash.Add(skipFirst);
+    }
+
+    hash.Add(h.v);
+    hash.Add((uint32_t)type);
+    hash.Add((uint32_t)subtype);
+    hash.Add((uint32_t)srcg->meshCombine);
+    hash.Add(color);
+    hash.Add(suppress);
+    hash.Add(IsForcedToMesh());
+    hash.Add(SS.ChordTolMm());
+    hash.Add(SS.GetMaxSegments());
+
+    for(int i = 0; i < 7; i++) {
+        Param *p = SK.param.FindByIdNoOops(h.param(i));
+        if(p) hash.Add(p->val);
+    }
+
+    if(type == Type::EXTRUDE || type == Type::LATHE) {
+        Group *src = SK.GetGroup(opA);
+        hash.Add((uint32_t)src->polyError.how);
+        hash.Add(src->bezierLoops);
+    }
+    if(type == Type::EXTRUDE) {
+        // The side faces get named after the line segments that they came
+        // from, so those handles are inputs too.
+        for(const Entity &e : SK.entity) {
+            if(e.group.v != opA.v) continue;
+            if(e.type != Entity::Type::LINE_SEGMENT) continue;
+            hash.Add(e.h.v);
+            hash.Add(SK.GetEntity(e.point[0])->PointGetNum());
+            hash.Add(SK.GetEntity(e.point[1])->PointGetNum());
+        }
+    } else if(type == Type::LATHE) {
+        hash.Add(SK.GetEntity(predef.origin)->PointGetNum());
+        hash.Add(SK.GetEntity(predef.entityB)->VectorGetNum());
+    } else if(type == Type::LINKED) {
+        hash.Add(scale);
+        hash.Add(impMesh);
+        hash.Add(impShell);
+    }
+
+    Group *prevg = srcg->RunningMeshGroup();
+    hash.Add(prevg ? prevg->shellMeshKey : 0);
+
+    // Zero is reserved to mean that we don't have a valid result.
+    return (hash.v == 0) ? 1 : hash.v;
+}
+
+//-----------------------------------------------------------------------------
+// The shells and meshes that we've generated, by key. A group's own copy
+// doesn't survive undo or redo, which snapshot the group without them, but
+// these do, so stepping through the undo stack needn't redo the Booleans.
+// It's bounded and cleared like the geometry caches; the cost is roughly
+// in triangles.
+//-----------------------------------------------------------------------------
+class ShellMeshStore : public GeometryCacheBase {
+public:
+    struct Entry {
+        SShell  thisShell;
+        SShell  runningShell;
+        SMesh   thisMesh;
+        SMesh   runningMesh;
+    };
+    std::map<uint64_t, Entry>   entry;
+    size_t                      cost;
+
+    static const size_t LIMIT = 1 << 19;
+
+    static size_t CostOf(const SShell *sh) {
+        size_t c = 4*sh->surface.n;
+        for(const SCurve &sc : sh->curve) {
+            c += sc.pts.n;
+        }
+        return c;
+    }
+
+    bool Find(uint64_t key, Group *g) {
+        auto it = entry.find(key);
+        if(it == entry.end()) return false;
+
+        Entry *e = &it->second;
+        g->thisShell.MakeFromCopyOf(&e->thisShell);
+        g->runningShell.MakeFromCopyOf(&e->runningShell);
+        g->thisMesh.MakeFromCopyOf(&e->thisMesh);
+        g->runningMesh.MakeFromCopyOf(&e->runningMesh);
+        return true;
+    }
+
+    void Insert(uint64_t key, Group *g) {
+        if(entry.find(key) != entry.end()) return;
+
+        size_t c = CostOf(&g->thisShell) + CostOf(&g->runningShell) +
+                   g->thisMesh.l.n + g->runningMesh.l.n;
+        if(c > LIMIT) return;
+        if(cost + c > LIMIT) Clear();
+
+        Entry *e = &entry[key];
+        e->thisShell = {};
+        e->runningShell = {};
+        e->thisMesh = {};
+        e->runningMesh = {};
+        e->thisShell.MakeFromCopyOf(&g->thisShell);
+        e->runningShell.MakeFromCopyOf(&g->runningShell);
+        e->thisMesh.MakeFromCopyOf(&g->thisMesh);
+        e->runningMesh.MakeFromCopyOf(&g->runningMesh);
+        cost += c;
+    }
+
+    void Clear() override {
+        for(auto &it : entry) {
+            Entry *e = &it.second;
+            e->thisShell.Clear();
+            e->runningShell.Clear();
+            e->thisMesh.Clear();
+            e->runningMesh.Clear();
+        }
+        entry.clear();
+        cost = 0;
+    }
+};
+static ShellMeshStore ShellMeshes;
+
 void Group::GenerateShellAndMesh() {
+    // If none of our inputs have changed, then the shell and mesh that we
+    // generated last time are still good, and we can skip the Booleans. But
+    // always retry a failed Boolean, since that's what marks the naked edges.
+    uint64_t key = ComputeShellMeshKey();
+    if(key == shellMeshKey && !booleanFailed) {
+        // And then our display items are still good too.
+        return;
+    }
+
     bool prevBooleanFailed = booleanFailed;
     booleanFailed = false;
 
-    Group *srcg = this;
+    // Build the new shells and meshes in place of the old ones, but hold on
+    // to those; if the regeneration gets cancelled, then we put them back.
+    SShell prevThisShell    = thisShell,
+           prevRunningShell = runningShell;
+    SMesh  prevThisMesh     = thisMesh,
+           prevRunningMesh  = runningMesh;
+    thisShell    = {};
+    thisMesh     = {};
+    runningShell = {};
+    runningMesh  = {};
+    auto clearPrev = [&]() {
+        prevThisShell.Clear();
+        prevThisMesh.Clear();
+        prevRunningShell.Clear();
+        prevRunningMesh.Clear();
+    };
+
+    // We may have made these before, e.g. before an undo.
+    if(ShellMeshes.Find(key, this)) {
+        clearPrev();
+        if(prevBooleanFailed) SS.ScheduleShowTW();
+        shellMeshKey = key;
+        displayDirty = true;
+        return;
+    }
 
-    thisShell.Clear();
-    thisMesh.Clear();
-    runningShell.Clear();
-    runningMesh.Clear();
+    Group *srcg = this;
 
     // Don't attempt a lathe or extrusion unless the source section is good:
     // planar and not self-intersecting.
@@ -313,7 +581,9 @@ void Group::GenerateShellAndMesh() {
         thisShell.RemapFaces(this, 0);
     }
 
-    if(srcg->meshCombine != CombineAs::ASSEMBLE) {
+    // A cancelled Boolean leaves a shell that's only partly built, and that
+    // we'll throw away anyways.
+    if(srcg->meshCombine != CombineAs::ASSEMBLE && !SS.IsGenerateCancelled()) {
         thisShell.MergeCoincidentSurfaces();
     }
 
@@ -323,19 +593,21 @@ void Group::GenerateShellAndMesh() {
 
     Group *prevg = srcg->RunningMeshGroup();
 
-    if(!IsForcedToMesh()) {
+    if(SS.IsGenerateCancelled()) {
+        // Don't bother starting the Boolean.
+    } else if(!IsForcedToMesh()) {
         SShell *prevs = &(prevg->runningShell);
         GenerateForBoolean<SShell>(prevs, &thisShell, &runningShell,
             srcg->meshCombine);
 
-        if(srcg->meshCombine != CombineAs::ASSEMBLE) {
+        if(srcg->meshCombine != CombineAs::ASSEMBLE && !SS.IsGenerateCancelled()) {
             runningShell.MergeCoincidentSurfaces();
         }
 
         // If the Boolean failed, then we should note that in the text screen
         // for this group.
         booleanFailed = runningShell.booleanFailed;
-        if(booleanFailed != prevBooleanFailed) {
+        if(booleanFailed != prevBooleanFailed && !SS.IsGenerateCancelled()) {
             SS.ScheduleShowTW();
         }
     } else {
@@ -367,64 +639,93 @@ void Group::GenerateShellAndMesh() {
         prevm.Clear();
     }
 
+    if(SS.IsGenerateCancelled()) {
+        // Whatever we made is incomplete, so discard it and restore the
+        // results from last time, along with their key.
+        thisShell.Clear();
+        thisMesh.Clear();
+        runningShell.Clear();
+        runningMesh.Clear();
+        thisShell    = prevThisShell;
+        thisMesh     = prevThisMesh;
+        runningShell = prevRunningShell;
+        runningMesh  = prevRunningMesh;
+        booleanFailed = prevBooleanFailed;
+        return;
+    }
+    clearPrev();
+
+    // A failed Boolean gets retried every time, so don't keep it.
+    if(!booleanFailed) ShellMeshes.Insert(key, this);
+
+    shellMeshKey = key;
     displayDirty = true;
 }
 
 void Group::GenerateDisplayItems() {
-    // This is potentially slow (since we've got to triangulate a shell, or
-    // to find the emphasized edges for a mesh), so we will run it only
-    // if its inputs have changed.
-    if(displayDirty) {
-        Group *pg = RunningMeshGroup();
-        if(pg && thisMesh.IsEmpty() && thisShell.IsEmpty()) {
-            // We don't contribute any new solid model in this group, so our
-            // display items are identical to the previous group's; which means
-            // that we can just display those, and stop ourselves from
-            // recalculating for those every time we get a change in this group.
-            //
-            // Note that this can end up recursing multiple times (if multiple
-            // groups that contribute no solid model exist in sequence), but
-            // that's okay.
-            pg->GenerateDisplayItems();
-
-            displayMesh.Clear();
-            displayMesh.MakeFromCopyOf(&(pg->displayMesh));
-
-            displayOutlines.Clear();
-            if(SS.GW.showEdges || SS.GW.showOutlines) {
-                displayOutlines.MakeFromCopyOf(&pg->displayOutlines);
-            }
-        } else {
-            // We do contribute new solid model, so we have to triangulate the
-            // shell, and edge-find the mesh.
-            displayMesh.Clear();
-            runningShell.TriangulateInto(&displayMesh);
-            STriangle *t;
-            for(t = runningMesh.l.First(); t; t = runningMesh.l.NextAfter(t)) {
-                STriangle trn = *t;
-                Vector n = trn.Normal();
-                trn.an = n;
-                trn.bn = n;
-                trn.cn = n;
-                displayMesh.AddTriangle(&trn);
-            }
+    // We don't contribute any new solid model in this group, so our display
+    // items are identical to the previous group's; which means that we can
+    // just display those, instead of keeping a copy of our own.
+    //
+    // Note that this can end up recursing multiple times (if multiple groups
+    // that contribute no solid model exist in sequence), but that's okay.
+    Group *dg = DisplayItemsGroup();
+    if(dg != this) {
+        ClearDisplayItems();
+        dg->GenerateDisplayItems();
+    } else {
+        // This is potentially slow (since we've got to triangulate a shell,
+        // or to find the emphasized edges for a mesh), so we will run it
+        // only if its inputs have changed, and only for the groups that get
+        // drawn.
+        bool needOutlines = (SS.GW.showEdges || SS.GW.showOutlines);
+        if(displayDirty || (displayOutlinesDirty && needOutlines)) {
+            GenerateDisplayMeshAndOutlines(needOutlines);
+        }
+    }
 
-            displayOutlines.Clear();
+    // Recalculate mass center if needed
+    if(SS.centerOfMass.draw && SS.centerOfMass.dirty && h.v == SS.GW.activeGroup.v) {
+        SS.UpdateCenterOfMass();
+    }
+}
 
-            if(SS.GW.showEdges || SS.GW.showOutlines) {
-                SOutlineList rawOutlines = {};
-                if(runningMesh.l.n > 0) {
-                    // Triangle mesh only; no shell or emphasized edges.
-                    runningMesh.MakeOutlinesInto(&rawOutlines, EdgeKind::EMPHASIZED);
-                } else {
-                    displayMesh.MakeOutlinesInto(&rawOutlines, EdgeKind::SHARP);
-                }
+Group *Group::DisplayItemsGroup() {
+    Group *pg = RunningMeshGroup();
+    if(pg && thisMesh.IsEmpty() && thisShell.IsEmpty()) {
+        return pg->DisplayItemsGroup();
+    }
+    return this;
+}
 
-                PolylineBuilder builder;
-                builder.MakeFromOutlines(rawOutlines);
-                builder.GenerateOutlines(&displayOutlines);
-                rawOutlines.Clear();
-            }
+SMesh *Group::DisplayMesh() {
+    return &(DisplayItemsGroup()->displayMesh);
+}
+
+SOutlineList *Group::DisplayOutlines() {
+    return &(DisplayItemsGroup()->displayOutlines);
+}
+
+void Group::ClearDisplayItems() {
+    displayMesh.Clear();
+    displayOutlines.Clear();
+    displayDirty = true;
+    displayOutlinesDirty = true;
+}
+
+void Group::GenerateDisplayMeshAndOutlines(bool needOutlines) {
+    if(displayDirty) {
+        // We contribute new solid model, so we have to triangulate the shell.
+        displayMesh.Clear();
+        runningShell.TriangulateInto(&displayMesh);
+        STriangle *t;
+        for(t = runningMesh.l.First(); t; t = runningMesh.l.NextAfter(t)) {
+            STriangle trn = *t;
+            Vector n = trn.Normal();
+            trn.an = n;
+            trn.bn = n;
+            trn.cn = n;
+            displayMesh.AddTriangle(&trn);
         }
 
         // If we render this mesh, we need to know whether it's transparent,
@@ -432,12 +733,29 @@ void Group::GenerateDisplayItems() {
         // work correctly.
         displayMesh.PrecomputeTransparency();
 
-        // Recalculate mass center if needed
-        if(SS.centerOfMass.draw && SS.centerOfMass.dirty && h.v == SS.GW.activeGroup.v) {
-            SS.UpdateCenterOfMass();
-        }
+        // Any outlines that we had were found from the old mesh.
+        displayOutlines.Clear();
+        displayOutlinesDirty = true;
         displayDirty = false;
     }
+
+    if(displayOutlinesDirty && needOutlines) {
+        // Edge-find the mesh.
+        displayOutlines.Clear();
+        SOutlineList rawOutlines = {};
+        if(runningMesh.l.n > 0) {
+            // Triangle mesh only; no shell or emphasized edges.
+            runningMesh.MakeOutlinesInto(&rawOutlines, EdgeKind::EMPHASIZED);
+        } else {
+            displayMesh.MakeOutlinesInto(&rawOutlines, EdgeKind::SHARP);
+        }
+
+        PolylineBuilder builder;
+        builder.MakeFromOutlines(rawOutlines);
+        builder.GenerateOutlines(&displayOutlines);
+        rawOutlines.Clear();
+        displayOutlinesDirty = false;
+    }
 }
 
 Group *Group::PreviousGroup() const {
@@ -475,6 +793,8 @@ void Group::DrawMesh(DrawMeshAs how, Canvas *canvas) {
     if(!(SS.GW.showShaded ||
          SS.GW.drawOccludedAs != GraphicsWindow::DrawOccludedAs::VISIBLE)) return;
 
+    const SMesh &displayMesh = *DisplayMesh();
+
     switch(how) {
         case DrawMeshAs::DEFAULT: {
             // Force the shade color to something dim to not distract from
@@ -566,6 +886,8 @@ void Group::Draw(Canvas *canvas) {
     GenerateDisplayItems();
     DrawMesh(DrawMeshAs::DEFAULT, canvas);
 
+    const SOutlineList &displayOutlines = *DisplayOutlines();
+
     if(SS.GW.showEdges) {
         Canvas::Stroke strokeEdge = Style::Stroke(Style::SOLID_EDGE);
         strokeEdge.zIndex = 1;
@@ -240,11 +240,45 @@ void SMesh::Simplify(int start) {
     FreeTemporary(conv);
 }
 
-void SMesh::AddAgainstBsp(SMesh *srcm, SBsp3 *bsp3) {
+//-----------------------------------------------------------------------------
+// Add the parts of the triangles of srcm that we keep, given bsp3 built from
+// the other operand agnst. A triangle that lies entirely outside agnst's
+// bounding box can't cross any of its faces, so it's all on one side; then
+// classifying one point tells us whether to keep all or none of it, without
+// splitting it against the planes of the tree.
+//-----------------------------------------------------------------------------
+void SMesh::AddAgainstBsp(SMesh *srcm, SBsp3 *bsp3, const SMesh *agnst) {
     int i;
 
+    Vector amax, amin;
+    agnst->GetBounding(&amax, &amin);
+
     for(i = 0; i < srcm->l.n; i++) {
+        if(SS.IsGenerateCancelled()) break;
+
         STriangle *st = &(srcm->l.elem[i]);
+
+        Vector tmax = st->a, tmin = st->a;
+        (st->b).MakeMaxMin(&tmax, &tmin);
+        (st->c).MakeMaxMin(&tmax, &tmin);
+        if(Vector::BoundingBoxesDisjoint(amax, amin, tmax, tmin)) {
+            Vector tc = ((st->a).Plus(st->b).Plus(st->c)).ScaledBy(1.0/3);
+            BspClass c = bsp3 ? bsp3->ClassifyPoint(tc) : BspClass::POS;
+            if(c == BspClass::POS) {
+                // Outside the other operand, same as an empty tree.
+                if(!flipNormal) {
+                    AddTriangle(st->meta, st->a, st->b, st->c);
+                }
+                continue;
+            } else if(c == BspClass::NEG) {
+                if(flipNormal) {
+                    AddTriangle(st->meta, st->c, st->b, st->a);
+                }
+                continue;
+            }
+            // And if it's on some plane of the tree, then do it the long way.
+        }
+
         int pn = l.n;
         atLeastOneDiscarded = false;
         SBsp3::InsertOrCreate(bsp3, st, this);
@@ -268,11 +302,11 @@ void SMesh::MakeFromUnionOf(SMesh *a, SMesh *b) {
 
     flipNormal = false;
     keepCoplanar = false;
-    AddAgainstBsp(b, bspa);
+    AddAgainstBsp(b, bspa, a);
 
     flipNormal = false;
     keepCoplanar = true;
-    AddAgainstBsp(a, bspb);
+    AddAgainstBsp(a, bspb, b);
 }
 
 void SMesh::MakeFromDifferenceOf(SMesh *a, SMesh *b) {
@@ -281,11 +315,11 @@ void SMesh::MakeFromDifferenceOf(SMesh *a, SMesh *b) {
 
     flipNormal = true;
     keepCoplanar = true;
-    AddAgainstBsp(b, bspa);
+    AddAgainstBsp(b, bspa, a);
 
     flipNormal = false;
     keepCoplanar = false;
-    AddAgainstBsp(a, bspb);
+    AddAgainstBsp(a, bspb, b);
 }
 
 void SMesh::MakeFromCopyOf(SMesh *a) {
@@ -324,6 +358,45 @@ bool SMesh::IsEmpty() const {
     return (l.n == 0);
 }
 
+void SIndexedTriMesh::Clear() {
+    vertex.clear();
+    normal.clear();
+    triangle.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Index the triangles of m. Each vertex (or normal) gets the index of the
+// first one before it that's Equals() to it, just like an SPointList would
+// give, but found with a hash instead of by searching the whole list.
+//-----------------------------------------------------------------------------
+static uint32_t IndexInPool(SEndpointHash *hash, std::vector<Vector> *pool,
+                            Vector p)
+{
+    int i = hash->FirstEqualTo(p, [](int) { return true; });
+    if(i < 0) {
+        i = (int)pool->size();
+        pool->push_back(p);
+        hash->Add(p, i);
+    }
+    return (uint32_t)i;
+}
+
+void SIndexedTriMesh::MakeFromMesh(const SMesh *m) {
+    Clear();
+
+    SEndpointHash vertices = {}, normals = {};
+    triangle.reserve(m->l.n);
+    for(const STriangle &tr : m->l) {
+        Triangle t;
+        for(int i = 0; i < 3; i++) {
+            t.vertex[i] = IndexInPool(&vertices, &vertex, tr.vertices[i]);
+            t.normal[i] = IndexInPool(&normals,  &normal, tr.normals[i]);
+        }
+        t.meta = tr.meta;
+        triangle.push_back(t);
+    }
+}
+
 uint32_t SMesh::FirstIntersectionWith(Point2d mp) const {
     Vector rayPoint = SS.GW.UnProjectPoint3(Vector::From(mp.x, mp.y, 0.0));
     Vector rayDir = SS.GW.UnProjectPoint3(Vector::From(mp.x, mp.y, 1.0)).Minus(rayPoint);
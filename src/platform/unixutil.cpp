@@ -64,11 +64,14 @@ typedef struct _AllocTempHeader {
 } AllocTempHeader;
 
 static AllocTempHeader *Head = NULL;
+// Parts of the NURBS Boolean run on several threads at once.
+static std::mutex HeadMutex;
 
 void *AllocTemporary(size_t n)
 {
     AllocTempHeader *h =
         (AllocTempHeader *)malloc(n + sizeof(AllocTempHeader));
+    std::lock_guard<std::mutex> lock(HeadMutex);
     h->prev = NULL;
     h->next = Head;
     if(Head) Head->prev = h;
@@ -80,6 +83,7 @@ void *AllocTemporary(size_t n)
 void FreeTemporary(void *p)
 {
     AllocTempHeader *h = (AllocTempHeader *)p - 1;
+    std::lock_guard<std::mutex> lock(HeadMutex);
     if(h->prev) {
         h->prev->next = h->next;
     } else {
@@ -91,6 +95,7 @@ void FreeTemporary(void *p)
 
 void FreeAllTemporary(void)
 {
+    std::lock_guard<std::mutex> lock(HeadMutex);
     AllocTempHeader *h = Head;
     while(h) {
         AllocTempHeader *f = h;
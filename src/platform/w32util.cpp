@@ -54,39 +54,41 @@ void assert_failure(const char *file, unsigned line, const char *function,
 //-----------------------------------------------------------------------------
 void *AllocTemporary(size_t n)
 {
-    void *v = HeapAlloc(TempHeap, HEAP_NO_SERIALIZE | HEAP_ZERO_MEMORY, n);
+    void *v = HeapAlloc(TempHeap, HEAP_ZERO_MEMORY, n);
     ssassert(v != NULL, "Cannot allocate memory");
     return v;
 }
 void FreeTemporary(void *p) {
-    HeapFree(TempHeap, HEAP_NO_SERIALIZE, p);
+    HeapFree(TempHeap, 0, p);
 }
 void FreeAllTemporary()
 {
     if(TempHeap) HeapDestroy(TempHeap);
-    TempHeap = HeapCreate(HEAP_NO_SERIALIZE, 1024*1024*20, 0);
+    TempHeap = HeapCreate(0, 1024*1024*20, 0);
     // This is a good place to validate, because it gets called fairly
     // often.
     vl();
 }
 
 void *MemAlloc(size_t n) {
-    void *p = HeapAlloc(PermHeap, HEAP_NO_SERIALIZE | HEAP_ZERO_MEMORY, n);
+    void *p = HeapAlloc(PermHeap, HEAP_ZERO_MEMORY, n);
     ssassert(p != NULL, "Cannot allocate memory");
     return p;
 }
 void MemFree(void *p) {
-    HeapFree(PermHeap, HEAP_NO_SERIALIZE, p);
+    HeapFree(PermHeap, 0, p);
 }
 
 void vl() {
-    ssassert(HeapValidate(TempHeap, HEAP_NO_SERIALIZE, NULL), "Corrupted heap");
-    ssassert(HeapValidate(PermHeap, HEAP_NO_SERIALIZE, NULL), "Corrupted heap");
+    ssassert(HeapValidate(TempHeap, 0, NULL), "Corrupted heap");
+    ssassert(HeapValidate(PermHeap, 0, NULL), "Corrupted heap");
 }
 
 std::vector<std::string> InitPlatform(int argc, char **argv) {
     // Create the heap used for long-lived stuff (that gets freed piecewise).
-    PermHeap = HeapCreate(HEAP_NO_SERIALIZE, 1024*1024*20, 0);
+    // Neither heap is created with HEAP_NO_SERIALIZE, since parts of the
+    // NURBS Boolean allocate from several threads at once.
+    PermHeap = HeapCreate(0, 1024*1024*20, 0);
     // Create the heap that we use to store Exprs and other temp stuff.
     FreeAllTemporary();
 
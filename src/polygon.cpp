@@ -211,34 +211,76 @@ void SEdgeList::AddEdge(Vector a, Vector b, int auxA, int auxB, int tag) {
     l.Add(&e);
 }
 
-bool SEdgeList::AssembleContour(Vector first, Vector last, SContour *dest,
-                                SEdge *errorAt, bool keepDir) const
+//-----------------------------------------------------------------------------
+// Points within LENGTH_EPS of each other are at most one cell apart.
+//-----------------------------------------------------------------------------
+static const double ENDPOINT_CELL = 2*LENGTH_EPS;
+
+uint64_t SEndpointHash::KeyFor(int64_t x, int64_t y, int64_t z) {
+    // Distinct cells may collide; that just puts their points in the same
+    // bucket, where they get tested anyways.
+    return ((uint64_t)x * 73856093ULL) ^
+           ((uint64_t)y * 19349663ULL) ^
+           ((uint64_t)z * 83492791ULL);
+}
+
+void SEndpointHash::Add(Vector p, int id) {
+    int64_t x = (int64_t)floor(p.x / ENDPOINT_CELL),
+            y = (int64_t)floor(p.y / ENDPOINT_CELL),
+            z = (int64_t)floor(p.z / ENDPOINT_CELL);
+    cell[KeyFor(x, y, z)].push_back({ p, id });
+}
+
+//-----------------------------------------------------------------------------
+// Of the points that are Equals() to p and whose id is accepted, return the
+// lowest id; or -1 if there are none. So with ids assigned in order, this
+// finds the same thing as a linear search would.
+//-----------------------------------------------------------------------------
+int SEndpointHash::FirstEqualTo(Vector p,
+                                const std::function<bool(int)> &accept) const
 {
-    int i;
+    int64_t x = (int64_t)floor(p.x / ENDPOINT_CELL),
+            y = (int64_t)floor(p.y / ENDPOINT_CELL),
+            z = (int64_t)floor(p.z / ENDPOINT_CELL);
+
+    int best = -1;
+    for(int dx = -1; dx <= 1; dx++) {
+        for(int dy = -1; dy <= 1; dy++) {
+            for(int dz = -1; dz <= 1; dz++) {
+                auto it = cell.find(KeyFor(x + dx, y + dy, z + dz));
+                if(it == cell.end()) continue;
+                for(const Entry &e : it->second) {
+                    if(best >= 0 && e.id >= best) continue;
+                    if(!e.p.Equals(p)) continue;
+                    if(!accept(e.id)) continue;
+                    best = e.id;
+                }
+            }
+        }
+    }
+    return best;
+}
 
+//-----------------------------------------------------------------------------
+// Chain together edges to form a contour, starting from the edge from first
+// to last. We take whichever unused edge comes first in our list; the ends
+// of edge i are in the hash as 2*i (for a) and 2*i + 1 (for b).
+//-----------------------------------------------------------------------------
+bool SEdgeList::AssembleContour(Vector first, Vector last, SContour *dest,
+                                SEdge *errorAt, bool keepDir,
+                                const SEndpointHash *ends) const
+{
     dest->AddPoint(first);
     dest->AddPoint(last);
 
     do {
-        for(i = 0; i < l.n; i++) {
-            SEdge *se = &(l.elem[i]);
-            if(se->tag) continue;
-
-            if(se->a.Equals(last)) {
-                dest->AddPoint(se->b);
-                last = se->b;
-                se->tag = 1;
-                break;
-            }
+        int id = ends->FirstEqualTo(last, [&](int id) {
+            if(l.elem[id / 2].tag) return false;
             // Don't allow backwards edges if keepDir is true.
-            if(!keepDir && se->b.Equals(last)) {
-                dest->AddPoint(se->a);
-                last = se->a;
-                se->tag = 1;
-                break;
-            }
-        }
-        if(i >= l.n) {
+            if(keepDir && (id % 2) == 1) return false;
+            return true;
+        });
+        if(id < 0) {
             // Couldn't assemble a closed contour; mark where.
             if(errorAt) {
                 errorAt->a = first;
@@ -247,6 +289,15 @@ bool SEdgeList::AssembleContour(Vector first, Vector last, SContour *dest,
             return false;
         }
 
+        SEdge *se = &(l.elem[id / 2]);
+        if((id % 2) == 0) {
+            dest->AddPoint(se->b);
+            last = se->b;
+        } else {
+            dest->AddPoint(se->a);
+            last = se->a;
+        }
+        se->tag = 1;
     } while(!last.Equals(first));
 
     return true;
@@ -255,12 +306,20 @@ bool SEdgeList::AssembleContour(Vector first, Vector last, SContour *dest,
 bool SEdgeList::AssemblePolygon(SPolygon *dest, SEdge *errorAt, bool keepDir) const {
     dest->Clear();
 
+    SEndpointHash ends = {};
+    int i;
+    for(i = 0; i < l.n; i++) {
+        ends.Add(l.elem[i].a, 2*i);
+        ends.Add(l.elem[i].b, 2*i + 1);
+    }
+
     bool allClosed = true;
+    // Edges only ever get used, so the first unused one never moves back.
+    i = 0;
     for(;;) {
         Vector first = Vector::From(0, 0, 0);
         Vector last  = Vector::From(0, 0, 0);
-        int i;
-        for(i = 0; i < l.n; i++) {
+        for(; i < l.n; i++) {
             if(!l.elem[i].tag) {
                 first = l.elem[i].a;
                 last = l.elem[i].b;
@@ -276,7 +335,7 @@ bool SEdgeList::AssemblePolygon(SPolygon *dest, SEdge *errorAt, bool keepDir) co
         // into that contour.
         dest->AddEmptyContour();
         if(!AssembleContour(first, last, &(dest->l.elem[dest->l.n-1]),
-                errorAt, keepDir))
+                errorAt, keepDir, &ends))
         {
             allClosed = false;
         }
@@ -477,25 +536,143 @@ int SKdNodeEdges::AnyEdgeCrossings(Vector a, Vector b, int cnt,
     return inters;
 }
 
+void SEdgeGrid::Init(Vector maxv, Vector minv, int n) {
+    // Aim for about one item per cell.
+    double w = maxv.x - minv.x, h = maxv.y - minv.y;
+    cell = sqrt(max(w*h, 0.0) / max(n, 1));
+    if(cell < LENGTH_EPS) cell = max(max(w, h), LENGTH_EPS) / max(n, 1);
+    if(cell < LENGTH_EPS) cell = LENGTH_EPS;
+
+    origin = minv;
+    nx = min((int)(w / cell) + 1, max(n, 1));
+    ny = min((int)(h / cell) + 1, max(n, 1));
+    bin.clear();
+    bin.resize((size_t)nx * ny);
+}
+
 //-----------------------------------------------------------------------------
-// We have an edge list that contains only collinear edges, maybe with more
-// splits than necessary. Merge any collinear segments that join.
+// The range of cells that a box touches, grown by a bit more than the
+// LENGTH_EPS slop of the tests that will run on what we find there. Anything
+// outside the grid gets clamped into the cells along its edge.
+//-----------------------------------------------------------------------------
+// The cell containing coordinate v, clamped to [0, n-1]. That's done before
+// the cast, since a point far outside the grid (or a NaN) might not fit in
+// an int.
+static int ClampedCell(double v, int n) {
+    v = floor(v);
+    if(!(v > 0)) return 0;
+    if(v > n - 1) return n - 1;
+    return (int)v;
+}
+
+void SEdgeGrid::CellRange(Vector maxv, Vector minv,
+                          int *x0, int *y0, int *x1, int *y1) const
+{
+    double tol = 2*LENGTH_EPS;
+    *x0 = ClampedCell((minv.x - tol - origin.x) / cell, nx);
+    *y0 = ClampedCell((minv.y - tol - origin.y) / cell, ny);
+    *x1 = ClampedCell((maxv.x + tol - origin.x) / cell, nx);
+    *y1 = ClampedCell((maxv.y + tol - origin.y) / cell, ny);
+}
+
+void SEdgeGrid::AddEdge(Vector a, Vector b, int auxA) {
+    SEdge se = SEdge::From(a, b);
+    se.auxA = auxA;
+    Vector maxv = a, minv = a;
+    b.MakeMaxMin(&maxv, &minv);
+
+    int x0, y0, x1, y1;
+    CellRange(maxv, minv, &x0, &y0, &x1, &y1);
+    for(int y = y0; y <= y1; y++) {
+        for(int x = x0; x <= x1; x++) {
+            bin[(size_t)y*nx + x].push_back(se);
+        }
+    }
+}
+
+void SEdgeGrid::AddPoint(Vector p, int auxA) {
+    AddEdge(p, p, auxA);
+}
+
+//-----------------------------------------------------------------------------
+// Remove one copy of a point; there may be others, since a contour that
+// has been bridged visits the ends of the bridge twice.
 //-----------------------------------------------------------------------------
-static Vector LineStart, LineDirection;
-static int ByTAlongLine(const void *av, const void *bv)
+void SEdgeGrid::RemovePoint(Vector p) {
+    int x0, y0, x1, y1;
+    CellRange(p, p, &x0, &y0, &x1, &y1);
+    for(int y = y0; y <= y1; y++) {
+        for(int x = x0; x <= x1; x++) {
+            std::vector<SEdge> *b = &bin[(size_t)y*nx + x];
+            for(size_t i = 0; i < b->size(); i++) {
+                if((*b)[i].a.EqualsExactly(p) && (*b)[i].b.EqualsExactly(p)) {
+                    b->erase(b->begin() + i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Call fn for the edges that might touch the box, until it returns true. An
+// edge that spans several cells may be seen more than once.
+//-----------------------------------------------------------------------------
+bool SEdgeGrid::AnyNear(Vector maxv, Vector minv,
+                        const std::function<bool(const SEdge &)> &fn) const
 {
-    SEdge *a = (SEdge *)av,
-          *b = (SEdge *)bv;
+    int x0, y0, x1, y1;
+    CellRange(maxv, minv, &x0, &y0, &x1, &y1);
+    for(int y = y0; y <= y1; y++) {
+        for(int x = x0; x <= x1; x++) {
+            for(const SEdge &se : bin[(size_t)y*nx + x]) {
+                if(fn(se)) return true;
+            }
+        }
+    }
+    return false;
+}
 
-    double ta = (a->a.Minus(LineStart)).DivPivoting(LineDirection),
-           tb = (b->a.Minus(LineStart)).DivPivoting(LineDirection);
+//-----------------------------------------------------------------------------
+// List the auxA of each edge whose bounding box overlaps the given box (to
+// within LENGTH_EPS), in increasing order and without repeats.
+//-----------------------------------------------------------------------------
+void SEdgeGrid::IdsNear(Vector maxv, Vector minv, std::vector<int> *ids) const {
+    ids->clear();
+    AnyNear(maxv, minv, [&](const SEdge &se) {
+        Vector emax = se.a, emin = se.a;
+        (se.b).MakeMaxMin(&emax, &emin);
+        emax.z = emin.z = 0;
+        if(!Vector::BoundingBoxesDisjoint(emax, emin,
+                Vector::From(maxv.x, maxv.y, 0), Vector::From(minv.x, minv.y, 0)))
+        {
+            ids->push_back(se.auxA);
+        }
+        return false;
+    });
+    std::sort(ids->begin(), ids->end());
+    ids->erase(std::unique(ids->begin(), ids->end()), ids->end());
+}
 
-    return (ta > tb) ? 1 : -1;
+bool SEdgeGrid::AnyEdgeCrosses(Vector a, Vector b) const {
+    Vector maxv = a, minv = a;
+    b.MakeMaxMin(&maxv, &minv);
+    return AnyNear(maxv, minv, [&](const SEdge &se) {
+        return se.EdgeCrosses(a, b);
+    });
 }
+
+//-----------------------------------------------------------------------------
+// We have an edge list that contains only collinear edges, maybe with more
+// splits than necessary. Merge any collinear segments that join.
+//-----------------------------------------------------------------------------
 void SEdgeList::MergeCollinearSegments(Vector a, Vector b) {
-    LineStart = a;
-    LineDirection = b.Minus(a);
-    qsort(l.elem, l.n, sizeof(l.elem[0]), ByTAlongLine);
+    Vector lineStart = a, lineDirection = b.Minus(a);
+    std::sort(l.begin(), l.end(), [&](const SEdge &ea, const SEdge &eb) {
+        double ta = (ea.a.Minus(lineStart)).DivPivoting(lineDirection),
+               tb = (eb.a.Minus(lineStart)).DivPivoting(lineDirection);
+        return ta < tb;
+    });
 
     l.ClearTags();
     int i;
@@ -652,6 +829,25 @@ bool SContour::ContainsPointProjdToNormal(Vector n, Vector p) const {
     return inside;
 }
 
+//-----------------------------------------------------------------------------
+// The bounding box of the contour, in the same projected coordinates that
+// ContainsPointProjdToNormal works in, as (u, v, 0). A point outside that
+// box (by more than LENGTH_EPS, say) is certainly not in the contour.
+//-----------------------------------------------------------------------------
+void SContour::GetBoundingBoxProjdToNormal(Vector n, Vector *maxv,
+                                           Vector *minv) const
+{
+    Vector u = n.Normal(0);
+    Vector v = n.Normal(1);
+
+    *maxv = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, 0);
+    *minv = Vector::From(VERY_POSITIVE, VERY_POSITIVE, 0);
+    for(const SPoint &sp : l) {
+        Vector pp = Vector::From((sp.p).Dot(u), (sp.p).Dot(v), 0);
+        pp.MakeMaxMin(maxv, minv);
+    }
+}
+
 void SContour::Reverse() {
     l.Reverse();
 }
@@ -712,8 +908,28 @@ void SPolygon::FixContourDirections() {
     // At output, the contour's tag will be 1 if we reversed it, else 0.
     l.ClearTags();
 
+    // Bin the contours by their bounding boxes, so that we needn't test
+    // each point against every contour.
+    Vector u = normal.Normal(0), v = normal.Normal(1);
+    SEdgeGrid boxes = {};
+    Vector gmax = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, 0),
+           gmin = Vector::From(VERY_POSITIVE, VERY_POSITIVE, 0);
+    std::vector<Vector> cmax(l.n), cmin(l.n);
+    int i;
+    for(i = 0; i < l.n; i++) {
+        if(l.elem[i].l.n < 1) continue;
+        l.elem[i].GetBoundingBoxProjdToNormal(normal, &cmax[i], &cmin[i]);
+        cmax[i].MakeMaxMin(&gmax, &gmin);
+        cmin[i].MakeMaxMin(&gmax, &gmin);
+    }
+    boxes.Init(gmax, gmin, l.n);
+    for(i = 0; i < l.n; i++) {
+        if(l.elem[i].l.n < 1) continue;
+        boxes.AddEdge(cmin[i], cmax[i], i);
+    }
+
     // Outside curve looks counterclockwise, projected against our normal.
-    int i, j;
+    std::vector<int> nearby;
     for(i = 0; i < l.n; i++) {
         SContour *sc = &(l.elem[i]);
         if(sc->l.n < 2) continue;
@@ -721,10 +937,12 @@ void SPolygon::FixContourDirections() {
         // testing a vertex for point-in-polygon may fail, but the midpoint
         // of an edge is okay.
         Vector pt = (((sc->l.elem[0]).p).Plus(sc->l.elem[1].p)).ScaledBy(0.5);
+        Vector pp = Vector::From(pt.Dot(u), pt.Dot(v), 0);
+        boxes.IdsNear(pp, pp, &nearby);
 
         sc->timesEnclosed = 0;
         bool outer = true;
-        for(j = 0; j < l.n; j++) {
+        for(int j : nearby) {
             if(i == j) continue;
             SContour *sct = &(l.elem[j]);
             if(sct->ContainsPointProjdToNormal(normal, pt)) {
@@ -45,6 +45,25 @@ public:
     bool EdgeCrosses(Vector a, Vector b, Vector *pi=NULL, SPointList *spl=NULL) const;
 };
 
+//-----------------------------------------------------------------------------
+// A spatial hash of points, each tagged with an integer id (typically saying
+// which end of which edge or curve it is). The cells are big enough that
+// any two points that are Equals() lie in the same or adjacent cells, so we
+// can find everything coincident with a point without testing every point.
+//-----------------------------------------------------------------------------
+class SEndpointHash {
+public:
+    struct Entry {
+        Vector  p;
+        int     id;
+    };
+    std::unordered_map<uint64_t, std::vector<Entry>> cell;
+
+    static uint64_t KeyFor(int64_t x, int64_t y, int64_t z);
+    void Add(Vector p, int id);
+    int FirstEqualTo(Vector p, const std::function<bool(int)> &accept) const;
+};
+
 class SEdgeList {
 public:
     List<SEdge>     l;
@@ -53,7 +72,8 @@ public:
     void AddEdge(Vector a, Vector b, int auxA=0, int auxB=0, int tag=0);
     bool AssemblePolygon(SPolygon *dest, SEdge *errorAt, bool keepDir=false) const;
     bool AssembleContour(Vector first, Vector last, SContour *dest,
-                            SEdge *errorAt, bool keepDir) const;
+                            SEdge *errorAt, bool keepDir,
+                            const SEndpointHash *ends) const;
     int AnyEdgeCrossings(Vector a, Vector b,
         Vector *pi=NULL, SPointList *spl=NULL) const;
     bool ContainsEdgeFrom(const SEdgeList *sel) const;
@@ -91,6 +111,32 @@ public:
         Vector *pi=NULL, SPointList *spl=NULL) const;
 };
 
+//-----------------------------------------------------------------------------
+// A uniform grid over a region of the xy plane, recording which edges (or
+// points, as zero-length edges) touch each cell. The triangulation works in
+// uv, and uses this to find what's near an ear or a bridge without testing
+// every vertex and edge of the polygon.
+//-----------------------------------------------------------------------------
+class SEdgeGrid {
+public:
+    Vector                          origin;
+    double                          cell;
+    int                             nx, ny;
+    std::vector<std::vector<SEdge>> bin;
+
+    void Init(Vector maxv, Vector minv, int n);
+    void AddEdge(Vector a, Vector b, int auxA=0);
+    void AddPoint(Vector p, int auxA=0);
+    void RemovePoint(Vector p);
+    bool AnyNear(Vector maxv, Vector minv,
+                 const std::function<bool(const SEdge &)> &fn) const;
+    bool AnyEdgeCrosses(Vector a, Vector b) const;
+    void IdsNear(Vector maxv, Vector minv, std::vector<int> *ids) const;
+
+    void CellRange(Vector maxv, Vector minv,
+                   int *x0, int *y0, int *x1, int *y1) const;
+};
+
 class SPoint {
 public:
     int     tag;
@@ -126,14 +172,18 @@ public:
     double SignedAreaProjdToNormal(Vector n) const;
     bool IsClockwiseProjdToNormal(Vector n) const;
     bool ContainsPointProjdToNormal(Vector n, Vector p) const;
+    void GetBoundingBoxProjdToNormal(Vector n, Vector *maxv, Vector *minv) const;
     void OffsetInto(SContour *dest, double r) const;
     void CopyInto(SContour *dest) const;
     void FindPointWithMinX();
     Vector AnyEdgeMidpoint() const;
 
-    bool IsEar(int bp, double scaledEps) const;
-    bool BridgeToContour(SContour *sc, SEdgeList *el, List<Vector> *vl);
-    void ClipEarInto(SMesh *m, int bp, double scaledEps);
+    bool IsEar(int ap, int bp, int cp, double scaledEps,
+               const SEdgeGrid *pts) const;
+    void UpdateEar(int ap, int bp, int cp, double scaledEps,
+                   const SEdgeGrid *pts, SSurface *srf);
+    bool BridgeToContour(SContour *sc, SEdgeGrid *eg, List<Vector> *vl);
+    void ClipEarInto(SMesh *m, int ap, int bp, int cp, double scaledEps) const;
     void UvTriangulateInto(SMesh *m, SSurface *srf);
 };
 
@@ -236,6 +286,7 @@ public:
     void InsertHow(BspClass how, STriangle *str, SMesh *instead);
     void Insert(STriangle *str, SMesh *instead);
     static SBsp3 *InsertOrCreate(SBsp3 *where, STriangle *str, SMesh *instead);
+    BspClass ClassifyPoint(Vector p) const;
 
     void InsertConvexHow(BspClass how, STriMeta meta, Vector *vertex, size_t n,
                                 SMesh *instead);
@@ -265,7 +316,7 @@ public:
 
     void Simplify(int start);
 
-    void AddAgainstBsp(SMesh *srcm, SBsp3 *bsp3);
+    void AddAgainstBsp(SMesh *srcm, SBsp3 *bsp3, const SMesh *agnst);
     void MakeFromUnionOf(SMesh *a, SMesh *b);
     void MakeFromDifferenceOf(SMesh *a, SMesh *b);
 
@@ -288,6 +339,30 @@ public:
     Vector GetCenterOfMass() const;
 };
 
+//-----------------------------------------------------------------------------
+// A mesh as a pool of vertices (and of normals), with each triangle given by
+// indices into those pools. Vertices that are Equals() get merged, so the
+// vertices that an SMesh repeats for every triangle that shares them are
+// stored just once. This is built from an SMesh, for the exporters whose
+// formats are indexed too; it doesn't replace the SMesh, so it's worth
+// making only for as long as it's needed.
+//-----------------------------------------------------------------------------
+class SIndexedTriMesh {
+public:
+    struct Triangle {
+        uint32_t    vertex[3];
+        uint32_t    normal[3];
+        STriMeta    meta;
+    };
+
+    std::vector<Vector>     vertex;
+    std::vector<Vector>     normal;
+    std::vector<Triangle>   triangle;
+
+    void Clear();
+    void MakeFromMesh(const SMesh *m);
+};
+
 // A linked list of triangles
 class STriangleLl {
 public:
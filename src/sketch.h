@@ -110,6 +110,23 @@ public:
     void Clear() {}
 };
 
+// The key for looking up an EntityMap by what it maps from.
+class EntityKey {
+public:
+    hEntity     input;
+    int         copyNumber;
+};
+struct EntityKeyHash {
+    size_t operator()(const EntityKey &k) const {
+        return ((size_t)k.input.v * 61) + (size_t)k.copyNumber;
+    }
+};
+struct EntityKeyEqual {
+    bool operator()(const EntityKey &a, const EntityKey &b) const {
+        return a.input.v == b.input.v && a.copyNumber == b.copyNumber;
+    }
+};
+
 // A set of requests. Every request must have an associated group.
 class Group {
 public:
@@ -201,7 +218,16 @@ public:
     SMesh           thisMesh;
     SMesh           runningMesh;
 
+    // A hash of all the inputs that produced the shells and meshes above;
+    // if those haven't changed, then we needn't regenerate. Zero if unknown.
+    uint64_t        shellMeshKey;
+
+    // The display items are built lazily, when the group is drawn; the mesh
+    // whenever the shell changes, and the outlines only if they're shown.
+    // A group that adds no solid model shares its predecessor's, so use
+    // DisplayMesh() and DisplayOutlines() to get at them.
     bool            displayDirty;
+    bool            displayOutlinesDirty;
     SMesh           displayMesh;
     SOutlineList    displayOutlines;
 
@@ -215,8 +241,9 @@ public:
     bool forceToMesh;
 
     IdList<EntityMap,EntityId> remap;
-    enum { REMAP_PRIME = 19477 };
-    int remapCache[REMAP_PRIME];
+    // Index into remap, rebuilt from it whenever the two are out of step
+    // (since only the list gets saved, or copied for undo).
+    std::unordered_map<EntityKey, EntityId, EntityKeyHash, EntityKeyEqual> remapCache;
 
     Platform::Path linkFile;
     SMesh       impMesh;
@@ -277,10 +304,16 @@ public:
     Group *RunningMeshGroup() const;
     bool IsMeshGroup();
 
+    uint64_t ComputeShellMeshKey();
     void GenerateShellAndMesh();
     template<class T> void GenerateForStepAndRepeat(T *steps, T *outs, Group::CombineAs forWhat);
     template<class T> void GenerateForBoolean(T *a, T *b, T *o, Group::CombineAs how);
     void GenerateDisplayItems();
+    void GenerateDisplayMeshAndOutlines(bool needOutlines);
+    Group *DisplayItemsGroup();
+    SMesh *DisplayMesh();
+    SOutlineList *DisplayOutlines();
+    void ClearDisplayItems();
 
     enum class DrawMeshAs { DEFAULT, HOVERED, SELECTED };
     void DrawMesh(DrawMeshAs how, Canvas *canvas);
@@ -104,6 +104,8 @@ void SolveSpaceUI::Init() {
     RefreshRecentMenus();
     // Autosave timer
     autosaveInterval = CnfThawInt(5, "AutosaveInterval");
+    // Time limit for regenerating the solid model
+    generateTimeLimit = CnfThawInt(0, "GenerateTimeLimit");
     // Locale
     std::string locale = CnfThawString("", "Locale");
     if(!locale.empty()) {
@@ -224,6 +226,8 @@ void SolveSpaceUI::Exit() {
     CnfFreezeBool(showToolbar, "ShowToolbar");
     // Autosave timer
     CnfFreezeInt(autosaveInterval, "AutosaveInterval");
+    // Time limit for regenerating the solid model
+    CnfFreezeInt(generateTimeLimit, "GenerateTimeLimit");
 
     // And the default styles, colors and line widths and such.
     Style::FreezeDefaultStyles();
@@ -601,7 +605,7 @@ void SolveSpaceUI::MenuAnalyze(Command id) {
         case Command::INTERFERENCE: {
             SS.nakedEdges.Clear();
 
-            SMesh *m = &(SK.GetGroup(SS.GW.activeGroup)->displayMesh);
+            SMesh *m = SK.GetGroup(SS.GW.activeGroup)->DisplayMesh();
             SKdNode *root = SKdNode::From(m);
             bool inters, leaks;
             root->MakeCertainEdgesInto(&(SS.nakedEdges),
@@ -626,7 +630,7 @@ void SolveSpaceUI::MenuAnalyze(Command id) {
         }
 
         case Command::VOLUME: {
-            SMesh *m = &(SK.GetGroup(SS.GW.activeGroup)->displayMesh);
+            SMesh *m = SK.GetGroup(SS.GW.activeGroup)->DisplayMesh();
 
             double vol = 0;
             int i;
@@ -793,7 +797,7 @@ void SolveSpaceUI::ShowNakedEdges(bool reportOnlyWhenNotOkay) {
     SS.nakedEdges.Clear();
 
     Group *g = SK.GetGroup(SS.GW.activeGroup);
-    SMesh *m = &(g->displayMesh);
+    SMesh *m = g->DisplayMesh();
     SKdNode *root = SKdNode::From(m);
     bool inters, leaks;
     root->MakeCertainEdgesInto(&(SS.nakedEdges),
@@ -812,7 +816,7 @@ void SolveSpaceUI::ShowNakedEdges(bool reportOnlyWhenNotOkay) {
         "The mesh is watertight (okay, valid).";
 
     std::string cntMsg = ssprintf("\n\nThe model contains %d triangles, from "
-                    "%d surfaces.", g->displayMesh.l.n, g->runningShell.surface.n);
+                    "%d surfaces.", m->l.n, g->runningShell.surface.n);
 
     if(SS.nakedEdges.l.n == 0) {
         Message("%s\n\n%s\n\nZero problematic edges, good.%s",
@@ -870,6 +874,7 @@ void SolveSpaceUI::Clear() {
         if(i < undo.cnt) undo.d[i].Clear();
         if(i < redo.cnt) redo.d[i].Clear();
     }
+    GeometryCacheBase::ClearAll();
 }
 
 void Sketch::Clear() {
@@ -23,6 +23,7 @@
 #include <setjmp.h>
 #include <limits.h>
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -31,9 +32,12 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <map>
+#include <mutex>
+#include <random>
 #include <set>
 #include <chrono>
 #include <sstream>
+#include <thread>
 
 // We declare these in advance instead of simply using FT_Library
 // (defined as typedef FT_LibraryRec_* FT_Library) because including
@@ -297,6 +301,7 @@ void MakeMatrix(double *mat, double a11, double a12, double a13, double a14,
                              double a31, double a32, double a33, double a34,
                              double a41, double a42, double a43, double a44);
 void MultMatrix(double *mata, double *matb, double *matr);
+void ParallelFor(int n, const std::function<void(int)> &fn);
 
 std::string MakeAcceleratorLabel(int accel);
 void Message(const char *str, ...);
@@ -689,6 +694,7 @@ public:
     int      afterDecimalMm;
     int      afterDecimalFoot;
     int      autosaveInterval; // in minutes
+    int      generateTimeLimit; // in seconds, or zero for none
 
     std::string MmToString(double v);
     double ExprToMm(Expr *e);
@@ -781,6 +787,10 @@ public:
         hEntity     point;
     } traced;
     SEdgeList nakedEdges;
+    // Debug edges can be added from the threads of a NURBS Boolean.
+    std::mutex nakedEdgesMutex;
+    // The classifying BSPs built for the NURBS Booleans of the last regen.
+    SBspUv::Stats bspStats;
     struct {
         bool        draw;
         Vector      ptA;
@@ -836,6 +846,14 @@ public:
 
     void GenerateAll(Generate type = Generate::DIRTY, bool andFindFree = false,
                      bool genForBBox = false);
+    // Regenerating the solid model can be very slow. A regeneration of the
+    // dirty groups that's still going at generateDeadline gets abandoned, at
+    // the next group boundary or step of a Boolean; the groups that didn't
+    // finish keep their previous shells and meshes, and stay dirty.
+    int64_t           generateDeadline;
+    std::atomic<bool> generateCancelled;
+    bool              lastGenerateCancelled;
+    bool IsGenerateCancelled();
     void SolveGroup(hGroup hg, bool andFindFree);
     void SolveGroupAndReport(hGroup hg, bool andFindFree);
     SolveResult TestRankForGroup(hGroup hg);
@@ -876,6 +894,8 @@ public:
     // in release builds.
     SolveSpaceUI()
         : pTW(new TextWindow({})), TW(*pTW),
+          generateDeadline(0), generateCancelled(false),
+          lastGenerateCancelled(false),
           pSys(new System({})), sys(*pSys) {}
 
     ~SolveSpaceUI() {
@@ -6,8 +6,6 @@
 //-----------------------------------------------------------------------------
 #include "solvespace.h"
 
-static int I;
-
 void SShell::MakeFromUnionOf(SShell *a, SShell *b) {
     MakeFromBoolean(a, b, SSurface::CombineAs::UNION);
 }
@@ -24,17 +22,6 @@ void SShell::MakeFromDifferenceOf(SShell *a, SShell *b) {
 // the intersection of srfA and srfB.) Return a new pwl curve with everything
 // split.
 //-----------------------------------------------------------------------------
-static Vector LineStart, LineDirection;
-static int ByTAlongLine(const void *av, const void *bv)
-{
-    SInter *a = (SInter *)av,
-           *b = (SInter *)bv;
-
-    double ta = (a->p.Minus(LineStart)).DivPivoting(LineDirection),
-           tb = (b->p.Minus(LineStart)).DivPivoting(LineDirection);
-
-    return (ta > tb) ? 1 : -1;
-}
 SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
                                     SSurface *srfA, SSurface *srfB) const
 {
@@ -48,16 +35,48 @@ SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
     ret.pts.Add(p);
     p = pts.NextAfter(p);
 
+    // Rather than searching the shells for the surfaces near each pwl
+    // segment, search once for the surfaces near the whole curve. The slop
+    // covers the LENGTH_EPS that LineEntirelyOutsideBbox allows, both along
+    // the segment and across it, so any surface that a segment could hit is
+    // in the list; and each surface makes that exact test for itself.
+    Vector bmax = prev.p, bmin = prev.p;
+    for(const SCurvePt &pt : pts) {
+        (pt.p).MakeMaxMin(&bmax, &bmin);
+    }
+    Vector slop = Vector::From(2*LENGTH_EPS, 2*LENGTH_EPS, 2*LENGTH_EPS);
+    bmax = bmax.Plus(slop);
+    bmin = bmin.Minus(slop);
+
+    std::vector<SSurface *> srfs, srfsB;
+    if(agnstA) agnstA->SurfacesNearBox(bmax, bmin, &srfs);
+    if(agnstB) {
+        agnstB->SurfacesNearBox(bmax, bmin, &srfsB);
+        srfs.insert(srfs.end(), srfsB.begin(), srfsB.end());
+    }
+    // And then against each segment, by the same argument, we can cheaply
+    // skip the surfaces whose boxes are nowhere near the segment's.
+    std::vector<Vector> smax(srfs.size()), smin(srfs.size());
+    for(size_t i = 0; i < srfs.size(); i++) {
+        srfs[i]->GetAxisAlignedBounding(&smax[i], &smin[i]);
+    }
+
     for(; p; p = pts.NextAfter(p)) {
         List<SInter> il = {};
 
+        Vector segmax = prev.p, segmin = prev.p;
+        (p->p).MakeMaxMin(&segmax, &segmin);
+        segmax = segmax.Plus(slop);
+        segmin = segmin.Minus(slop);
+
         // Find all the intersections with the two passed shells
-        if(agnstA)
-            agnstA->AllPointsIntersecting(prev.p, p->p, &il,
-                /*asSegment=*/true, /*trimmed=*/false, /*inclTangent=*/true);
-        if(agnstB)
-            agnstB->AllPointsIntersecting(prev.p, p->p, &il,
+        for(size_t i = 0; i < srfs.size(); i++) {
+            if(Vector::BoundingBoxesDisjoint(smax[i], smin[i], segmax, segmin)) {
+                continue;
+            }
+            srfs[i]->AllPointsIntersecting(prev.p, p->p, &il,
                 /*asSegment=*/true, /*trimmed=*/false, /*inclTangent=*/true);
+        }
 
         if(il.n > 0) {
             // The intersections were generated by intersecting the pwl
@@ -104,9 +123,12 @@ SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
             // And now sort them in order along the line. Note that we must
             // do that after refining, in case the refining would make two
             // points switch places.
-            LineStart = prev.p;
-            LineDirection = (p->p).Minus(prev.p);
-            qsort(il.elem, il.n, sizeof(il.elem[0]), ByTAlongLine);
+            Vector lineStart = prev.p, lineDirection = (p->p).Minus(prev.p);
+            std::sort(il.begin(), il.end(), [&](const SInter &a, const SInter &b) {
+                double ta = (a.p.Minus(lineStart)).DivPivoting(lineDirection),
+                       tb = (b.p.Minus(lineStart)).DivPivoting(lineDirection);
+                return ta < tb;
+            });
 
             // And now uses the intersections to generate our split pwl edge(s)
             Vector prev = Vector::From(VERY_POSITIVE, 0, 0);
@@ -132,16 +154,23 @@ SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
 }
 
 void SShell::CopyCurvesSplitAgainst(bool opA, SShell *agnst, SShell *into) {
-    SCurve *sc;
-    for(sc = curve.First(); sc; sc = curve.NextAfter(sc)) {
-        SCurve scn = sc->MakeCopySplitAgainst(agnst, NULL,
+    // Each curve is split independently, so do that on several threads, and
+    // then add them in order so that they get the same handles regardless.
+    std::vector<SCurve> split(curve.n);
+    ParallelFor(curve.n, [&](int i) {
+        if(SS.IsGenerateCancelled()) return;
+
+        SCurve *sc = &(curve.elem[i]);
+        split[i] = sc->MakeCopySplitAgainst(agnst, NULL,
                                 surface.FindById(sc->surfA),
                                 surface.FindById(sc->surfB));
-        scn.source = opA ? SCurve::Source::A : SCurve::Source::B;
+        split[i].source = opA ? SCurve::Source::A : SCurve::Source::B;
+    });
 
-        hSCurve hsc = into->curve.AddAndAssignId(&scn);
+    for(int i = 0; i < curve.n; i++) {
+        hSCurve hsc = into->curve.AddAndAssignId(&split[i]);
         // And note the new ID so that we can rewrite the trims appropriately
-        sc->newH = hsc;
+        curve.elem[i].newH = hsc;
     }
 }
 
@@ -393,6 +422,35 @@ void SSurface::EdgeNormalsWithinSurface(Point2d auv, Point2d buv,
     *enout = pout.Minus(*pt);
 }
 
+//-----------------------------------------------------------------------------
+// Trim the new surface with the edges that we decided to keep, and check that
+// they actually make closed loops.
+//-----------------------------------------------------------------------------
+static void TrimFromChosenEdges(SSurface *ret, SEdgeList *final, SShell *into,
+                                int avoid)
+{
+    // Cull extraneous edges; duplicates or anti-parallel pairs. In particular,
+    // we can get duplicate edges if our surface intersects the other shell
+    // at an edge, so that both surfaces intersect coincident (and both
+    // generate an intersection edge).
+    final->CullExtraneousEdges();
+
+    // Use our reassembled edges to trim the new surface.
+    ret->TrimFromEdgeList(final, /*asUv=*/true);
+
+    SPolygon poly = {};
+    final->l.ClearTags();
+    if(!final->AssemblePolygon(&poly, NULL, /*keepDir=*/true)) {
+        // Other surfaces may be getting trimmed into the same shell on other
+        // threads.
+        std::lock_guard<std::mutex> lock(SS.nakedEdgesMutex);
+        into->booleanFailed = true;
+        dbp("failed: surface=%d, avoid=%d", ret->h.v, avoid);
+        DEBUGEDGELIST(final, ret);
+    }
+    poly.Clear();
+}
+
 //-----------------------------------------------------------------------------
 // Trim this surface against the specified shell, in the way that's appropriate
 // for the specified Boolean operation type (and which operand we are). We
@@ -432,6 +490,46 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
     SEdgeList orig = {};
     ret.MakeEdgesInto(into, &orig, MakeAs::UV);
     ret.trim.Clear();
+
+    // If no surface of the other shell comes anywhere near us, then there
+    // are no intersection curves on us, and we lie entirely inside or
+    // entirely outside that shell. So classifying any one edge tells us
+    // whether to keep all of our edges or none of them.
+    Vector bmax, bmin;
+    ret.GetAxisAlignedBounding(&bmax, &bmin);
+    std::vector<SSurface *> nearby;
+    agnst->SurfacesNearBox(bmax, bmin, &nearby);
+    if(nearby.empty()) {
+        SEdgeList final = {};
+        if(orig.l.n > 0) {
+            SEdge *se = &(orig.l.elem[0]);
+            Point2d auv  = (se->a).ProjectXy(),
+                    buv  = (se->b).ProjectXy();
+
+            Vector pt, enin, enout, surfn;
+            ret.EdgeNormalsWithinSurface(auv, buv, &pt, &enin, &enout, &surfn,
+                                            se->auxA, into, sha, shb);
+
+            SShell::Class indir_shell, outdir_shell;
+            agnst->ClassifyEdge(&indir_shell, &outdir_shell,
+                                ret.PointAt(auv), ret.PointAt(buv), pt,
+                                enin, enout, surfn);
+
+            if(KeepEdge(type, opA, indir_shell, outdir_shell,
+                        SShell::Class::INSIDE, SShell::Class::OUTSIDE))
+            {
+                for(se = orig.l.First(); se; se = orig.l.NextAfter(se)) {
+                    final.AddEdge(se->a, se->b, se->auxA, se->auxB);
+                }
+            }
+        }
+        TrimFromChosenEdges(&ret, &final, into, 0);
+
+        final.Clear();
+        orig.Clear();
+        return ret;
+    }
+
     // which means that we can't necessarily use the old BSP...
     SBspUv *origBsp = SBspUv::From(&orig, &ret);
 
@@ -465,8 +563,12 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
                     ret.ClosestPointTo(a, &(ta.x), &(ta.y));
                     ret.ClosestPointTo(b, &(tb.x), &(tb.y));
 
-                    Vector tn = ret.NormalAt(ta.x, ta.y);
-                    Vector sn = ss->NormalAt(auv.x, auv.y);
+                    // Take the normals at the middle of the edge; where the
+                    // surfaces are tangent (like at the end of the curve
+                    // where two equal cylinders meet), they're parallel at
+                    // the endpoint, and the sign below would be noise.
+                    Vector tn = ret.NormalAt((ta.x + tb.x)/2, (ta.y + tb.y)/2);
+                    Vector sn = ss->NormalAt((auv.x + buv.x)/2, (auv.y + buv.y)/2);
 
                     // We are subtracting the portion of our surface that
                     // lies in the shell, so the in-plane edge normal should
@@ -579,23 +681,7 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
         chain.Clear();
     }
 
-    // Cull extraneous edges; duplicates or anti-parallel pairs. In particular,
-    // we can get duplicate edges if our surface intersects the other shell
-    // at an edge, so that both surfaces intersect coincident (and both
-    // generate an intersection edge).
-    final.CullExtraneousEdges();
-
-    // Use our reassembled edges to trim the new surface.
-    ret.TrimFromEdgeList(&final, /*asUv=*/true);
-
-    SPolygon poly = {};
-    final.l.ClearTags();
-    if(!final.AssemblePolygon(&poly, NULL, /*keepDir=*/true)) {
-        into->booleanFailed = true;
-        dbp("failed: I=%d, avoid=%d", I, choosing.l.n);
-        DEBUGEDGELIST(&final, &ret);
-    }
-    poly.Clear();
+    TrimFromChosenEdges(&ret, &final, into, choosing.l.n);
 
     choosing.Clear();
     final.Clear();
@@ -605,25 +691,52 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
 }
 
 void SShell::CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type) {
-    SSurface *ss;
-    for(ss = surface.First(); ss; ss = surface.NextAfter(ss)) {
-        SSurface ssn;
-        ssn = ss->MakeCopyTrimAgainst(this, sha, shb, into, type);
-        ss->newH = into->surface.AddAndAssignId(&ssn);
-        I++;
+    // Every surface is trimmed against curves and shells that we no longer
+    // modify, so do that on several threads, and then add them in order.
+    std::vector<SSurface> trimmed(surface.n);
+    ParallelFor(surface.n, [&](int i) {
+        if(SS.IsGenerateCancelled()) return;
+
+        trimmed[i] = surface.elem[i].MakeCopyTrimAgainst(this, sha, shb, into, type);
+    });
+
+    for(int i = 0; i < surface.n; i++) {
+        surface.elem[i].newH = into->surface.AddAndAssignId(&trimmed[i]);
     }
 }
 
 void SShell::MakeIntersectionCurvesAgainst(SShell *agnst, SShell *into) {
-    SSurface *sa;
-    for(sa = surface.First(); sa; sa = surface.NextAfter(sa)) {
-        SSurface *sb;
-        for(sb = agnst->surface.First(); sb; sb = agnst->surface.NextAfter(sb)){
-            // Intersect every surface from our shell against every surface
-            // from agnst; this will add zero or more curves to the curve
-            // list for into.
-            sa->IntersectAgainst(sb, this, agnst, into);
+    // Intersect every surface from our shell against every surface from
+    // agnst whose bounding box overlaps it; this will add zero or more curves
+    // to the curve list for into. The pairs come back in the same order as
+    // a nested loop over both shells, so the curves get the same handles.
+    if(surfaceBvh.IsEmpty()) surfaceBvh.Build(this);
+    if(agnst->surfaceBvh.IsEmpty()) agnst->surfaceBvh.Build(agnst);
+
+    std::vector<std::pair<int, int>> pairs;
+    surfaceBvh.OverlappingPairsWith(&(agnst->surfaceBvh), &pairs);
+
+    // The pairs are intersected on several threads, each into a shell of its
+    // own, since the result of one pair can't affect the result of another
+    // until we merge them, one pair after another. The curves already in
+    // into were copied from the two shells before we started, so the threads
+    // may look at those.
+    std::vector<SShell> found(pairs.size());
+    ParallelFor((int)pairs.size(), [&](int i) {
+        if(SS.IsGenerateCancelled()) return;
+
+        SSurface *sa = &(surface.elem[pairs[i].first]),
+                 *sb = &(agnst->surface.elem[pairs[i].second]);
+        sa->IntersectAgainst(sb, this, agnst, &found[i], into);
+    });
+
+    for(SShell &f : found) {
+        for(SCurve &sc : f.curve) {
+            into->AddIntersectionCurve(&sc, this, agnst);
+            // and into now owns (or has freed) the points
+            sc.pts = {};
         }
+        f.curve.Clear();
     }
 }
 
@@ -632,6 +745,8 @@ void SShell::CleanupAfterBoolean() {
     for(ss = surface.First(); ss; ss = surface.NextAfter(ss)) {
         ss->edges.Clear();
     }
+    surfaceBvh.Clear();
+    edgeBvh.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -702,6 +817,17 @@ void SShell::MakeFromAssemblyOf(SShell *a, SShell *b) {
 void SShell::MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type) {
     booleanFailed = false;
 
+    // Each step below skips its work once the regeneration is cancelled, and
+    // the next one can't use what's left; the caller will throw away whatever
+    // we've got, so just stop.
+    auto cancelled = [&]() {
+        if(!SS.IsGenerateCancelled()) return false;
+        a->CleanupAfterBoolean();
+        b->CleanupAfterBoolean();
+        booleanFailed = true;
+        return true;
+    };
+
     a->MakeClassifyingBsps(NULL);
     b->MakeClassifyingBsps(NULL);
 
@@ -710,10 +836,12 @@ void SShell::MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type) {
     // shell.
     a->CopyCurvesSplitAgainst(/*opA=*/true,  b, this);
     b->CopyCurvesSplitAgainst(/*opA=*/false, a, this);
+    if(cancelled()) return;
 
     // Generate the intersection curves for each surface in A against all
     // the surfaces in B (which is all of the intersection curves).
     a->MakeIntersectionCurvesAgainst(b, this);
+    if(cancelled()) return;
 
     SCurve *sc;
     for(sc = curve.First(); sc; sc = curve.NextAfter(sc)) {
@@ -731,14 +859,10 @@ void SShell::MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type) {
     a->MakeClassifyingBsps(this);
     b->MakeClassifyingBsps(this);
 
-    if(b->surface.n == 0 || a->surface.n == 0) {
-        I = 1000000;
-    } else {
-        I = 0;
-    }
     // Then trim and copy the surfaces
     a->CopySurfacesTrimAgainst(a, b, this, type);
     b->CopySurfacesTrimAgainst(a, b, this, type);
+    if(cancelled()) return;
 
     // Now that we've copied the surfaces, we know their new hSurfaces, so
     // rewrite the curves to refer to the surfaces by their handles in the
@@ -758,13 +882,18 @@ void SShell::MakeClassifyingBsps(SShell *useCurvesFrom) {
     for(ss = surface.First(); ss; ss = surface.NextAfter(ss)) {
         ss->MakeClassifyingBsp(this, useCurvesFrom);
     }
+
+    // And the BVHs that we use to cast rays against this shell, and to find
+    // the trim edges (that we just made) near a point.
+    surfaceBvh.Build(this);
+    edgeBvh.BuildFromEdges(this);
 }
 
 void SSurface::MakeClassifyingBsp(SShell *shell, SShell *useCurvesFrom) {
     SEdgeList el = {};
 
     MakeEdgesInto(shell, &el, MakeAs::UV, useCurvesFrom);
-    bsp = SBspUv::From(&el, this);
+    bsp = SBspUv::From(&el, this, &SS.bspStats);
     el.Clear();
 
     edges = {};
@@ -788,7 +917,39 @@ static int ByLength(const void *av, const void *bv)
     return (la < lb) ? 1 : -1;
 }
 
-SBspUv *SBspUv::From(SEdgeList *el, SSurface *srf) {
+//-----------------------------------------------------------------------------
+// Is el a single closed loop that turns the same way at every vertex? Then
+// each edge has all of the others on one side of it, so any splitter is as
+// good as any other, and there's no point in searching for the best one.
+//-----------------------------------------------------------------------------
+static bool IsConvexLoop(SEdgeList *el) {
+    int n = el->l.n;
+    if(n < 3) return false;
+
+    double sign = 0, turned = 0;
+    for(int i = 0; i < n; i++) {
+        SEdge *e = &(el->l.elem[i]),
+              *f = &(el->l.elem[(i + 1) % n]);
+        if(!(e->b).Equals(f->a)) return false;
+
+        Point2d de = (e->b).Minus(e->a).ProjectXy(),
+                df = (f->b).Minus(f->a).ProjectXy();
+        double cross = de.x*df.y - de.y*df.x,
+               dot   = de.Dot(df);
+        turned += atan2(cross, dot);
+
+        // Consecutive edges that are nearly parallel don't tell us anything.
+        if(fabs(cross) < 1e-9*de.Magnitude()*df.Magnitude()) continue;
+        if(cross*sign < 0) return false;
+        sign = cross;
+    }
+    // And make sure that it doesn't wind around more than once.
+    return fabs(fabs(turned) - 2*PI) < 0.1;
+}
+
+SBspUv *SBspUv::From(SEdgeList *el, SSurface *srf, Stats *stats) {
+    bool convex = IsConvexLoop(el);
+
     SEdgeList work = {};
 
     SEdge *se;
@@ -797,13 +958,151 @@ SBspUv *SBspUv::From(SEdgeList *el, SSurface *srf) {
     }
     qsort(work.l.elem, work.l.n, sizeof(work.l.elem[0]), ByLength);
 
-    SBspUv *bsp = NULL;
+    // Each endpoint gets tested against every splitting line on its way down
+    // the tree, always linearized about that same point; so work out the
+    // scale there just once.
+    std::vector<BuildEdge> edges;
+    edges.reserve(work.l.n);
     for(se = work.l.First(); se; se = work.l.NextAfter(se)) {
-        bsp = InsertOrCreateEdge(bsp, (se->a).ProjectXy(), (se->b).ProjectXy(), srf);
+        BuildEdge be;
+        be.a  = (se->a).ProjectXy();
+        be.b  = (se->b).ProjectXy();
+        be.sa = ScaleAt(be.a, srf);
+        be.sb = ScaleAt(be.b, srf);
+        edges.push_back(be);
     }
-
     work.Clear();
-    return bsp;
+
+    return BuildFrom(&edges, srf, /*searchSplitter=*/!convex, 1, stats);
+}
+
+//-----------------------------------------------------------------------------
+// Where does edge e lie relative to the line through a and b? This makes the
+// same tests, in the same order, as InsertEdge.
+//-----------------------------------------------------------------------------
+enum class BspSide { COINCIDENT, POS, NEG, SPLIT };
+
+static BspSide SideOfLine(const SBspUv::BuildEdge &e, Point2d a, Point2d b,
+                          double *dea, double *deb)
+{
+    *dea = SBspUv::ScaledSignedDistanceToLine(e.a, a, b, e.sa);
+    *deb = SBspUv::ScaledSignedDistanceToLine(e.b, a, b, e.sb);
+
+    if(fabs(*dea) < LENGTH_EPS && fabs(*deb) < LENGTH_EPS) {
+        return BspSide::COINCIDENT;
+    } else if(fabs(*dea) < LENGTH_EPS) {
+        return (*deb > 0) ? BspSide::POS : BspSide::NEG;
+    } else if(fabs(*deb) < LENGTH_EPS) {
+        return (*dea > 0) ? BspSide::POS : BspSide::NEG;
+    } else if(*dea > 0 && *deb > 0) {
+        return BspSide::POS;
+    } else if(*dea < 0 && *deb < 0) {
+        return BspSide::NEG;
+    } else {
+        return BspSide::SPLIT;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Build the tree from a list of edges, longest first. Rather than just taking
+// the first edge as the splitting line, as inserting them one by one would,
+// we consider the first few (so still long ones, which give better normals)
+// and pick the one that splits the fewest edges and divides the rest most
+// evenly, unless searchSplitter is false. This consumes the list. If stats
+// isn't NULL, then the nodes that we create get counted there.
+//-----------------------------------------------------------------------------
+static const int BSP_SPLITTER_CANDIDATES = 8;
+
+SBspUv *SBspUv::BuildFrom(std::vector<BuildEdge> *edges, SSurface *srf,
+                          bool searchSplitter, int depth, Stats *stats)
+{
+    if(edges->empty()) return NULL;
+
+    int n = (int)edges->size();
+    int best = 0;
+    if(searchSplitter && n > 2) {
+        int bestScore = INT_MAX;
+        int candidates = min(n, BSP_SPLITTER_CANDIDATES);
+        for(int c = 0; c < candidates; c++) {
+            const BuildEdge &s = (*edges)[c];
+            int npos = 0, nneg = 0, nsplit = 0;
+            for(int i = 0; i < n; i++) {
+                if(i == c) continue;
+                double dea, deb;
+                switch(SideOfLine((*edges)[i], s.a, s.b, &dea, &deb)) {
+                    case BspSide::COINCIDENT:                break;
+                    case BspSide::POS:          npos++;     break;
+                    case BspSide::NEG:          nneg++;     break;
+                    case BspSide::SPLIT:        nsplit++;   break;
+                }
+            }
+            int score = abs(npos - nneg) + 4*nsplit;
+            if(score < bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+    }
+
+    SBspUv *node = Alloc();
+    node->a = (*edges)[best].a;
+    node->b = (*edges)[best].b;
+    if(stats) {
+        stats->nodes++;
+        stats->maxDepth = max(stats->maxDepth, depth);
+    }
+
+    std::vector<BuildEdge> pos, neg;
+    for(int i = 0; i < n; i++) {
+        if(i == best) continue;
+        const BuildEdge &e = (*edges)[i];
+        double dea, deb;
+        switch(SideOfLine(e, node->a, node->b, &dea, &deb)) {
+            case BspSide::COINCIDENT: {
+                // Line segment is coincident with this one, store in same node
+                SBspUv *m = Alloc();
+                m->a = e.a;
+                m->b = e.b;
+                m->more = node->more;
+                node->more = m;
+                if(stats) stats->nodes++;
+                break;
+            }
+            case BspSide::POS:
+                pos.push_back(e);
+                break;
+
+            case BspSide::NEG:
+                neg.push_back(e);
+                break;
+
+            case BspSide::SPLIT: {
+                // New edge crosses this one; we need to split.
+                Point2d nv = ((node->b.Minus(node->a)).Normal()).WithMagnitude(1);
+                double d = node->a.Dot(nv);
+                double t = (d - nv.Dot(e.a)) / (nv.Dot(e.b.Minus(e.a)));
+                Point2d pi = e.a.Plus((e.b.Minus(e.a)).ScaledBy(t));
+                Point2d spi = ScaleAt(pi, srf);
+
+                BuildEdge ea = { e.a, pi, e.sa, spi },
+                          eb = { pi, e.b, spi, e.sb };
+                if(dea > 0) {
+                    pos.push_back(ea);
+                    neg.push_back(eb);
+                } else {
+                    neg.push_back(ea);
+                    pos.push_back(eb);
+                }
+                break;
+            }
+        }
+    }
+    // We're done with our input, so free it before going deeper.
+    std::vector<BuildEdge>().swap(*edges);
+
+    node->pos = BuildFrom(&pos, srf, searchSplitter, depth + 1, stats);
+    node->neg = BuildFrom(&neg, srf, searchSplitter, depth + 1, stats);
+    return node;
 }
 
 //-----------------------------------------------------------------------------
@@ -816,10 +1115,15 @@ SBspUv *SBspUv::From(SEdgeList *el, SSurface *srf) {
 // which is when the linearization is accurate.
 //-----------------------------------------------------------------------------
 
-void SBspUv::ScalePoints(Point2d *pt, Point2d *a, Point2d *b, SSurface *srf) const {
+Point2d SBspUv::ScaleAt(Point2d pt, SSurface *srf) {
     Vector tu, tv;
-    srf->TangentsAt(pt->x, pt->y, &tu, &tv);
-    double mu = tu.Magnitude(), mv = tv.Magnitude();
+    srf->TangentsAt(pt.x, pt.y, &tu, &tv);
+    return Point2d::From(tu.Magnitude(), tv.Magnitude());
+}
+
+void SBspUv::ScalePoints(Point2d *pt, Point2d *a, Point2d *b, SSurface *srf) const {
+    Point2d s = ScaleAt(*pt, srf);
+    double mu = s.x, mv = s.y;
 
     pt->x *= mu; pt->y *= mv;
     a ->x *= mu; a ->y *= mv;
@@ -827,9 +1131,11 @@ void SBspUv::ScalePoints(Point2d *pt, Point2d *a, Point2d *b, SSurface *srf) con
 }
 
 double SBspUv::ScaledSignedDistanceToLine(Point2d pt, Point2d a, Point2d b,
-                                          SSurface *srf) const
+                                          Point2d scale)
 {
-    ScalePoints(&pt, &a, &b, srf);
+    pt.x *= scale.x; pt.y *= scale.y;
+    a .x *= scale.x; a .y *= scale.y;
+    b .x *= scale.x; b .y *= scale.y;
 
     Point2d n = ((b.Minus(a)).Normal()).WithMagnitude(1);
     double d = a.Dot(n);
@@ -837,6 +1143,12 @@ double SBspUv::ScaledSignedDistanceToLine(Point2d pt, Point2d a, Point2d b,
     return pt.Dot(n) - d;
 }
 
+double SBspUv::ScaledSignedDistanceToLine(Point2d pt, Point2d a, Point2d b,
+                                          SSurface *srf) const
+{
+    return ScaledSignedDistanceToLine(pt, a, b, ScaleAt(pt, srf));
+}
+
 double SBspUv::ScaledDistanceToLine(Point2d pt, Point2d a, Point2d b, bool asSegment,
                                     SSurface *srf) const
 {
@@ -903,13 +1215,24 @@ void SBspUv::InsertEdge(Point2d ea, Point2d eb, SSurface *srf) {
 }
 
 SBspUv::Class SBspUv::ClassifyPoint(Point2d p, Point2d eb, SSurface *srf) const {
-    double dp = ScaledSignedDistanceToLine(p, a, b, srf);
+    // Every test on the way down is linearized about p, so find the scale
+    // there just once.
+    return ClassifyPointScaled(p, eb, srf, ScaleAt(p, srf));
+}
+
+SBspUv::Class SBspUv::ClassifyPointScaled(Point2d p, Point2d eb, SSurface *srf,
+                                          Point2d scale) const
+{
+    double dp = ScaledSignedDistanceToLine(p, a, b, scale);
 
     if(fabs(dp) < LENGTH_EPS) {
         const SBspUv *f = this;
         while(f) {
             Point2d ba = (f->b).Minus(f->a);
-            if(ScaledDistanceToLine(p, f->a, ba, /*asSegment=*/true, srf) < LENGTH_EPS) {
+            Point2d ps  = Point2d::From(p.x*scale.x, p.y*scale.y),
+                    as  = Point2d::From(f->a.x*scale.x, f->a.y*scale.y),
+                    bas = Point2d::From(ba.x*scale.x, ba.y*scale.y);
+            if(ps.DistanceToLine(as, bas, /*asSegment=*/true) < LENGTH_EPS) {
                 if(ScaledDistanceToLine(eb, f->a, ba, /*asSegment=*/false, srf) < LENGTH_EPS){
                     if(ba.Dot(eb.Minus(p)) > 0) {
                         return Class::EDGE_PARALLEL;
@@ -923,16 +1246,16 @@ SBspUv::Class SBspUv::ClassifyPoint(Point2d p, Point2d eb, SSurface *srf) const
             f = f->more;
         }
         // Pick arbitrarily which side to send it down, doesn't matter
-        Class c1 =  neg ? neg->ClassifyPoint(p, eb, srf) : Class::OUTSIDE;
-        Class c2 =  pos ? pos->ClassifyPoint(p, eb, srf) : Class::INSIDE;
+        Class c1 =  neg ? neg->ClassifyPointScaled(p, eb, srf, scale) : Class::OUTSIDE;
+        Class c2 =  pos ? pos->ClassifyPointScaled(p, eb, srf, scale) : Class::INSIDE;
         if(c1 != c2) {
             dbp("MISMATCH: %d %d %08x %08x", c1, c2, neg, pos);
         }
         return c1;
     } else if(dp > 0) {
-        return pos ? pos->ClassifyPoint(p, eb, srf) : Class::INSIDE;
+        return pos ? pos->ClassifyPointScaled(p, eb, srf, scale) : Class::INSIDE;
     } else {
-        return neg ? neg->ClassifyPoint(p, eb, srf) : Class::OUTSIDE;
+        return neg ? neg->ClassifyPointScaled(p, eb, srf, scale) : Class::OUTSIDE;
     }
 }
 
@@ -948,13 +1271,18 @@ SBspUv::Class SBspUv::ClassifyEdge(Point2d ea, Point2d eb, SSurface *srf) const
 }
 
 double SBspUv::MinimumDistanceToEdge(Point2d p, SSurface *srf) const {
+    return MinimumDistanceToEdgeScaled(p, ScaleAt(p, srf));
+}
+
+double SBspUv::MinimumDistanceToEdgeScaled(Point2d p, Point2d scale) const {
 
-    double dn = (neg) ? neg->MinimumDistanceToEdge(p, srf) : VERY_POSITIVE;
-    double dp = (pos) ? pos->MinimumDistanceToEdge(p, srf) : VERY_POSITIVE;
+    double dn = (neg) ? neg->MinimumDistanceToEdgeScaled(p, scale) : VERY_POSITIVE;
+    double dp = (pos) ? pos->MinimumDistanceToEdgeScaled(p, scale) : VERY_POSITIVE;
 
-    Point2d as = a, bs = b;
-    ScalePoints(&p, &as, &bs, srf);
-    double d = p.DistanceToLine(as, bs.Minus(as), /*asSegment=*/true);
+    Point2d ps = Point2d::From(p.x*scale.x, p.y*scale.y),
+            as = Point2d::From(a.x*scale.x, a.y*scale.y),
+            bs = Point2d::From(b.x*scale.x, b.y*scale.y);
+    double d = ps.DistanceToLine(as, bs.Minus(as), /*asSegment=*/true);
 
     return min(d, min(dn, dp));
 }
@@ -0,0 +1,264 @@
+//-----------------------------------------------------------------------------
+// A bounding volume hierarchy over the surfaces of a shell, built from the
+// axis-aligned bounding boxes of their control polygons. This lets us skip
+// most pairs of surfaces that can't possibly intersect without looking at
+// each pair in turn.
+//-----------------------------------------------------------------------------
+#include "../solvespace.h"
+
+void SSurfaceBvh::Clear() {
+    item.clear();
+    node.clear();
+}
+
+void SSurfaceBvh::Build(SShell *shell) {
+    Clear();
+
+    int index = 0;
+    for(SSurface &ss : shell->surface) {
+        Item it;
+        ss.GetAxisAlignedBounding(&it.max, &it.min);
+        it.index = index++;
+        it.edge  = -1;
+        it.srf   = &ss;
+        item.push_back(it);
+    }
+    if(item.empty()) return;
+
+    node.reserve(2*item.size()/LEAF_SIZE + 1);
+    BuildRange(0, (int)item.size());
+}
+
+//-----------------------------------------------------------------------------
+// Build the tree over the xyz trim edges of every surface, as generated by
+// MakeClassifyingBsp, instead of over the surfaces themselves.
+//-----------------------------------------------------------------------------
+void SSurfaceBvh::BuildFromEdges(SShell *shell) {
+    Clear();
+
+    int index = 0;
+    for(SSurface &ss : shell->surface) {
+        for(int i = 0; i < ss.edges.l.n; i++) {
+            SEdge *se = &(ss.edges.l.elem[i]);
+            Item it;
+            it.max = it.min = se->a;
+            (se->b).MakeMaxMin(&it.max, &it.min);
+            it.index = index;
+            it.edge  = i;
+            it.srf   = &ss;
+            item.push_back(it);
+        }
+        index++;
+    }
+    if(item.empty()) return;
+
+    node.reserve(2*item.size()/LEAF_SIZE + 1);
+    BuildRange(0, (int)item.size());
+}
+
+//-----------------------------------------------------------------------------
+// Build the subtree over item[first, first+count), splitting at the median
+// along the axis where the centers of the boxes are most spread out, and
+// return the index of its root node.
+//-----------------------------------------------------------------------------
+int SSurfaceBvh::BuildRange(int first, int count) {
+    int n = (int)node.size();
+    node.push_back({});
+
+    Vector max = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, VERY_NEGATIVE),
+           min = Vector::From(VERY_POSITIVE, VERY_POSITIVE, VERY_POSITIVE),
+           cmax = max, cmin = min;
+    for(int i = first; i < first + count; i++) {
+        item[i].max.MakeMaxMin(&max, &min);
+        item[i].min.MakeMaxMin(&max, &min);
+        Vector c = (item[i].max).Plus(item[i].min).ScaledBy(0.5);
+        c.MakeMaxMin(&cmax, &cmin);
+    }
+    node[n].max   = max;
+    node[n].min   = min;
+    node[n].first = first;
+    node[n].count = count;
+
+    if(count <= LEAF_SIZE) {
+        node[n].child[0] = node[n].child[1] = -1;
+        return n;
+    }
+
+    Vector extent = cmax.Minus(cmin);
+    int axis = 0;
+    if(extent.Element(1) > extent.Element(axis)) axis = 1;
+    if(extent.Element(2) > extent.Element(axis)) axis = 2;
+
+    // Break ties by index, so that the tree doesn't depend on the sort.
+    int half = count / 2;
+    std::nth_element(item.begin() + first, item.begin() + first + half,
+                     item.begin() + first + count,
+        [&](const Item &a, const Item &b) {
+            double ca = a.max.Element(axis) + a.min.Element(axis),
+                   cb = b.max.Element(axis) + b.min.Element(axis);
+            if(ca != cb) return ca < cb;
+            if(a.index != b.index) return a.index < b.index;
+            return a.edge < b.edge;
+        });
+
+    // Recursing can reallocate the node list, so don't hold a reference.
+    int c0 = BuildRange(first, half);
+    int c1 = BuildRange(first + half, count - half);
+    node[n].child[0] = c0;
+    node[n].child[1] = c1;
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+// Find every pair of surfaces, one from this tree and one from b, whose
+// bounding boxes overlap (to within LENGTH_EPS, like IntersectAgainst). The
+// pairs are returned as indices into the two shells' surface lists, sorted
+// in the same order that a nested loop over both lists would visit them.
+//-----------------------------------------------------------------------------
+void SSurfaceBvh::OverlappingPairsWith(const SSurfaceBvh *b,
+                                       std::vector<std::pair<int, int>> *pairs) const
+{
+    pairs->clear();
+    if(IsEmpty() || b->IsEmpty()) return;
+
+    OverlappingPairsBelow(0, b, 0, pairs);
+    std::sort(pairs->begin(), pairs->end());
+}
+
+void SSurfaceBvh::OverlappingPairsBelow(int na, const SSurfaceBvh *b, int nb,
+                                        std::vector<std::pair<int, int>> *pairs) const
+{
+    const Node *a = &node[na], *o = &(b->node[nb]);
+    if(Vector::BoundingBoxesDisjoint(a->max, a->min, o->max, o->min)) return;
+
+    bool leafa = (a->child[0] < 0), leafb = (o->child[0] < 0);
+    if(leafa && leafb) {
+        for(int i = a->first; i < a->first + a->count; i++) {
+            const Item *ia = &item[i];
+            for(int j = o->first; j < o->first + o->count; j++) {
+                const Item *ib = &(b->item[j]);
+                if(Vector::BoundingBoxesDisjoint(ia->max, ia->min,
+                                                 ib->max, ib->min))
+                {
+                    continue;
+                }
+                pairs->emplace_back(ia->index, ib->index);
+            }
+        }
+    } else if(leafb || (!leafa && a->count >= o->count)) {
+        // Descend into whichever side is bigger, to keep the boxes that we
+        // compare of similar size.
+        OverlappingPairsBelow(a->child[0], b, nb, pairs);
+        OverlappingPairsBelow(a->child[1], b, nb, pairs);
+    } else {
+        OverlappingPairsBelow(na, b, o->child[0], pairs);
+        OverlappingPairsBelow(na, b, o->child[1], pairs);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Could the line (or segment) through a and b pass through the box? This
+// errs on the side of yes, by a bit more than the LENGTH_EPS slop that
+// SSurface::LineEntirelyOutsideBbox allows, since whoever asked will make
+// that exact test for each item anyways.
+//-----------------------------------------------------------------------------
+static bool LineMightHitBox(Vector a, Vector b, bool asSegment,
+                            Vector bmax, Vector bmin)
+{
+    double tol = 2*LENGTH_EPS;
+    Vector d = b.Minus(a);
+    double t0, t1;
+    if(asSegment) {
+        double m = d.Magnitude();
+        double ext = (m > 0) ? tol/m : 0;
+        t0 = -ext;
+        t1 = 1 + ext;
+    } else {
+        t0 = -VERY_POSITIVE;
+        t1 = VERY_POSITIVE;
+    }
+
+    for(int i = 0; i < 3; i++) {
+        double lo = bmin.Element(i) - tol, hi = bmax.Element(i) + tol,
+               p  = a.Element(i), di = d.Element(i);
+        if(di == 0) {
+            if(p < lo || p > hi) return false;
+            continue;
+        }
+        double ta = (lo - p)/di, tb = (hi - p)/di;
+        if(ta > tb) swap(ta, tb);
+        t0 = max(t0, ta);
+        t1 = min(t1, tb);
+        if(t0 > t1) return false;
+    }
+    return true;
+}
+
+static bool ByIndexThenEdge(const SSurfaceBvh::Item *a,
+                            const SSurfaceBvh::Item *b)
+{
+    if(a->index != b->index) return a->index < b->index;
+    return a->edge < b->edge;
+}
+
+//-----------------------------------------------------------------------------
+// Find every item whose bounding box the line (or segment) through a and b
+// might pass through, in the same order as they appear in the shell.
+//-----------------------------------------------------------------------------
+void SSurfaceBvh::ItemsNearLine(Vector a, Vector b, bool asSegment,
+                                std::vector<const Item *> *found) const
+{
+    found->clear();
+    if(IsEmpty()) return;
+
+    int stack[64], depth = 0;
+    stack[depth++] = 0;
+    while(depth > 0) {
+        const Node *n = &node[stack[--depth]];
+        if(!LineMightHitBox(a, b, asSegment, n->max, n->min)) continue;
+
+        if(n->child[0] < 0) {
+            for(int i = n->first; i < n->first + n->count; i++) {
+                const Item *it = &item[i];
+                if(!LineMightHitBox(a, b, asSegment, it->max, it->min)) continue;
+                found->push_back(it);
+            }
+        } else {
+            stack[depth++] = n->child[0];
+            stack[depth++] = n->child[1];
+        }
+    }
+    std::sort(found->begin(), found->end(), ByIndexThenEdge);
+}
+
+//-----------------------------------------------------------------------------
+// Find every item whose bounding box overlaps the given box (to within
+// LENGTH_EPS), in the same order as they appear in the shell.
+//-----------------------------------------------------------------------------
+void SSurfaceBvh::ItemsNearBox(Vector max, Vector min,
+                               std::vector<const Item *> *found) const
+{
+    found->clear();
+    if(IsEmpty()) return;
+
+    int stack[64], depth = 0;
+    stack[depth++] = 0;
+    while(depth > 0) {
+        const Node *n = &node[stack[--depth]];
+        if(Vector::BoundingBoxesDisjoint(n->max, n->min, max, min)) continue;
+
+        if(n->child[0] < 0) {
+            for(int i = n->first; i < n->first + n->count; i++) {
+                const Item *it = &item[i];
+                if(Vector::BoundingBoxesDisjoint(it->max, it->min, max, min)) {
+                    continue;
+                }
+                found->push_back(it);
+            }
+        } else {
+            stack[depth++] = n->child[0];
+            stack[depth++] = n->child[1];
+        }
+    }
+    std::sort(found->begin(), found->end(), ByIndexThenEdge);
+}
@@ -379,48 +379,31 @@ bool SBezierList::GetPlaneContainingBeziers(Vector *p, Vector *u, Vector *v,
 }
 
 //-----------------------------------------------------------------------------
-// Assemble curves in sbl into a single loop. The curves may appear in any
-// direction (start to finish, or finish to start), and will be reversed if
-// necessary. The curves in the returned loop are removed from sbl, even if
-// the loop cannot be closed.
+// Assemble a loop, starting from curve first, from the untagged curves in
+// sbl. We take whichever curve that joins on comes first in the list; the
+// ends of curve i are in the hash as 2*i (for the start) and 2*i + 1 (for
+// the finish). The curves that we use get tagged, and remaining counts down.
 //-----------------------------------------------------------------------------
-SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl,
-                                    bool *allClosed, SEdge *errorAt)
+static SBezierLoop LoopFromCurves(SBezierList *sbl, const SEndpointHash *ends,
+                                  int first, int *remaining,
+                                  bool *allClosed, SEdge *errorAt)
 {
     SBezierLoop loop = {};
 
-    if(sbl->l.n < 1) return loop;
-    sbl->l.ClearTags();
-
-    SBezier *first = &(sbl->l.elem[0]);
-    first->tag = 1;
-    loop.l.Add(first);
-    Vector start = first->Start();
-    Vector hanging = first->Finish();
-    int auxA = first->auxA;
-
-    sbl->l.RemoveTagged();
-
-    while(sbl->l.n > 0 && !hanging.Equals(start)) {
-        int i;
-        bool foundNext = false;
-        for(i = 0; i < sbl->l.n; i++) {
-            SBezier *test = &(sbl->l.elem[i]);
-
-            if((test->Finish()).Equals(hanging) && test->auxA == auxA) {
-                test->Reverse();
-                // and let the next test catch it
-            }
-            if((test->Start()).Equals(hanging) && test->auxA == auxA) {
-                test->tag = 1;
-                loop.l.Add(test);
-                hanging = test->Finish();
-                sbl->l.RemoveTagged();
-                foundNext = true;
-                break;
-            }
-        }
-        if(!foundNext) {
+    SBezier *fc = &(sbl->l.elem[first]);
+    fc->tag = 1;
+    (*remaining)--;
+    loop.l.Add(fc);
+    Vector start = fc->Start();
+    Vector hanging = fc->Finish();
+    int auxA = fc->auxA;
+
+    while(*remaining > 0 && !hanging.Equals(start)) {
+        int id = ends->FirstEqualTo(hanging, [&](int id) {
+            SBezier *test = &(sbl->l.elem[id / 2]);
+            return !test->tag && test->auxA == auxA;
+        });
+        if(id < 0) {
             // The loop completed without finding the hanging edge, so
             // it's an open loop
             errorAt->a = hanging;
@@ -428,6 +411,15 @@ SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl,
             *allClosed = false;
             return loop;
         }
+
+        SBezier *test = &(sbl->l.elem[id / 2]);
+        if((test->Finish()).Equals(hanging)) {
+            test->Reverse();
+        }
+        test->tag = 1;
+        (*remaining)--;
+        loop.l.Add(test);
+        hanging = test->Finish();
     }
     if(hanging.Equals(start)) {
         *allClosed = true;
@@ -441,6 +433,35 @@ SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl,
     return loop;
 }
 
+static void AddCurveEndsTo(SBezierList *sbl, SEndpointHash *ends) {
+    for(int i = 0; i < sbl->l.n; i++) {
+        ends->Add(sbl->l.elem[i].Start(),  2*i);
+        ends->Add(sbl->l.elem[i].Finish(), 2*i + 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Assemble curves in sbl into a single loop. The curves may appear in any
+// direction (start to finish, or finish to start), and will be reversed if
+// necessary. The curves in the returned loop are removed from sbl, even if
+// the loop cannot be closed.
+//-----------------------------------------------------------------------------
+SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl,
+                                    bool *allClosed, SEdge *errorAt)
+{
+    if(sbl->l.n < 1) return {};
+    sbl->l.ClearTags();
+
+    SEndpointHash ends = {};
+    AddCurveEndsTo(sbl, &ends);
+
+    int remaining = sbl->l.n;
+    SBezierLoop loop =
+        LoopFromCurves(sbl, &ends, 0, &remaining, allClosed, errorAt);
+    sbl->l.RemoveTagged();
+    return loop;
+}
+
 void SBezierLoop::Reverse() {
     l.Reverse();
     SBezier *sb;
@@ -495,11 +516,21 @@ SBezierLoopSet SBezierLoopSet::From(SBezierList *sbl, SPolygon *poly,
 {
     SBezierLoopSet ret = {};
 
+    // Hash the curves' ends just once for all the loops, and leave the
+    // curves that we've used in place (but tagged) until the end.
+    sbl->l.ClearTags();
+    SEndpointHash ends = {};
+    AddCurveEndsTo(sbl, &ends);
+
     *allClosed = true;
-    while(sbl->l.n > 0) {
+    int first = 0, remaining = sbl->l.n;
+    while(remaining > 0) {
+        while(sbl->l.elem[first].tag) first++;
+
         bool thisClosed;
         SBezierLoop loop;
-        loop = SBezierLoop::FromCurves(sbl, &thisClosed, errorAt);
+        loop = LoopFromCurves(sbl, &ends, first, &remaining,
+                              &thisClosed, errorAt);
         if(!thisClosed) {
             // Record open loops in a separate list, if requested.
             *allClosed = false;
@@ -516,6 +547,7 @@ SBezierLoopSet SBezierLoopSet::From(SBezierList *sbl, SPolygon *poly,
             loop.MakePwlInto(&(poly->l.elem[poly->l.n-1]), chordTol);
         }
     }
+    sbl->l.RemoveTagged();
 
     poly->normal = poly->ComputeNormal();
     ret.normal = poly->normal;
@@ -599,7 +631,7 @@ void SBezierLoopSetSet::FindOuterFacesFrom(SBezierList *sbl, SPolygon *spxyz,
         srfuv = &srfPlane;
     }
 
-    int i, j;
+    int i;
     // Assemble the Bezier trim curves into closed loops; we also get the
     // piecewise linearization of the curves (in the SPolygon spxyz), as a
     // calculation aid for the loop direction.
@@ -643,28 +675,55 @@ void SBezierLoopSetSet::FindOuterFacesFrom(SBezierList *sbl, SPolygon *spxyz,
         }
     }
 
+    // Bin the point that we test for each loop, so that we can find the
+    // ones that might lie within a loop from its bounding box, instead of
+    // testing all of them.
+    Vector nu = spuv.normal.Normal(0), nv = spuv.normal.Normal(1);
+    std::vector<Vector> cmax(spuv.l.n), cmin(spuv.l.n);
+    Vector gmax = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, 0),
+           gmin = Vector::From(VERY_POSITIVE, VERY_POSITIVE, 0);
+    for(i = 0; i < spuv.l.n; i++) {
+        SContour *contour = &(spuv.l.elem[i]);
+        contour->GetBoundingBoxProjdToNormal(spuv.normal, &cmax[i], &cmin[i]);
+        if(contour->l.n < 2) continue;
+        Vector p = contour->AnyEdgeMidpoint();
+        Vector::From(p.Dot(nu), p.Dot(nv), 0).MakeMaxMin(&gmax, &gmin);
+    }
+    SEdgeGrid midpoints = {};
+    midpoints.Init(gmax, gmin, spuv.l.n);
+    for(i = 0; i < spuv.l.n; i++) {
+        SContour *contour = &(spuv.l.elem[i]);
+        if(contour->l.n < 2) continue;
+        Vector p = contour->AnyEdgeMidpoint();
+        midpoints.AddPoint(Vector::From(p.Dot(nu), p.Dot(nv), 0), i);
+    }
+
+    std::vector<int> nearby;
     bool loopsRemaining = true;
     while(loopsRemaining) {
         loopsRemaining = false;
         for(i = 0; i < sbls.l.n; i++) {
             SBezierLoop *loop = &(sbls.l.elem[i]);
             if(loop->tag != OUTER_LOOP) continue;
+            midpoints.IdsNear(cmax[i], cmin[i], &nearby);
 
             // Check if this contour contains any outer loops; if it does, then
             // we should do those "inner outer loops" first; otherwise we
             // will steal their holes, since their holes also lie inside this
             // contour.
-            for(j = 0; j < sbls.l.n; j++) {
+            bool containsOuter = false;
+            for(int j : nearby) {
                 SBezierLoop *outer = &(sbls.l.elem[j]);
                 if(i == j) continue;
                 if(outer->tag != OUTER_LOOP) continue;
 
                 Vector p = spuv.l.elem[j].AnyEdgeMidpoint();
                 if(spuv.l.elem[i].ContainsPointProjdToNormal(spuv.normal, p)) {
+                    containsOuter = true;
                     break;
                 }
             }
-            if(j < sbls.l.n) {
+            if(containsOuter) {
                 // It does, can't do this one yet.
                 continue;
             }
@@ -676,7 +735,7 @@ void SBezierLoopSetSet::FindOuterFacesFrom(SBezierList *sbl, SPolygon *spxyz,
             int auxA = 0;
             if(loop->l.n > 0) auxA = loop->l.elem[0].auxA;
 
-            for(j = 0; j < sbls.l.n; j++) {
+            for(int j : nearby) {
                 SBezierLoop *inner = &(sbls.l.elem[j]);
                 if(inner->tag != INNER_LOOP) continue;
                 if(inner->l.n < 1) continue;
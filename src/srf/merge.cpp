@@ -6,12 +6,51 @@
 //-----------------------------------------------------------------------------
 #include "../solvespace.h"
 
+//-----------------------------------------------------------------------------
+// To find the candidates for merging without testing every pair of surfaces,
+// we bucket the planes by their normal and offset, quantized on a grid much
+// coarser than the tolerance of CoincidentWith. Two coincident planes might
+// still land on either side of a grid line, so we look in the neighbouring
+// cells too; the key is just a hint, and CoincidentWith has the last word.
+//-----------------------------------------------------------------------------
+static const double MERGE_NORMAL_CELL = 1.0/64;
+static const double MERGE_OFFSET_CELL = 0.1;
+
+static void PlaneCellOf(SSurface *ss, int64_t cell[4]) {
+    Vector n = ss->NormalAt(0, 0).WithMagnitude(1);
+    double d = n.Dot(ss->ctrl[0][0]);
+    for(int i = 0; i < 3; i++) {
+        cell[i] = (int64_t)floor(n.Element(i)/MERGE_NORMAL_CELL + 0.5);
+    }
+    cell[3] = (int64_t)floor(d/MERGE_OFFSET_CELL + 0.5);
+}
+
+static uint64_t PlaneKeyOf(const int64_t cell[4]) {
+    // A collision here only costs us an extra candidate, so it's fine to
+    // wrap around.
+    return ((uint64_t)(cell[0] & 0xff) << 56) |
+           ((uint64_t)(cell[1] & 0xff) << 48) |
+           ((uint64_t)(cell[2] & 0xff) << 40) |
+            (uint64_t)(cell[3] & 0xffffffffffULL);
+}
+
 void SShell::MergeCoincidentSurfaces() {
     surface.ClearTags();
 
-    int i, j;
+    int i;
     SSurface *si, *sj;
 
+    // We handle only coincident planes, so only those go in the buckets.
+    std::unordered_map<uint64_t, std::vector<int>> planes;
+    for(i = 0; i < surface.n; i++) {
+        si = &(surface.elem[i]);
+        if(si->degm != 1 || si->degn != 1) continue;
+        int64_t cell[4];
+        PlaneCellOf(si, cell);
+        planes[PlaneKeyOf(cell)].push_back(i);
+    }
+
+    std::vector<int> candidates;
     for(i = 0; i < surface.n; i++) {
         si = &(surface.elem[i]);
         if(si->tag) continue;
@@ -22,6 +61,28 @@ void SShell::MergeCoincidentSurfaces() {
         // time on other surfaces.
         if(si->degm != 1 || si->degn != 1) continue;
 
+        // Gather everything in this cell and the ones around it, and visit
+        // them in the same order as a scan through the whole shell would.
+        candidates.clear();
+        int64_t cell[4], probe[4];
+        PlaneCellOf(si, cell);
+        for(int k = 0; k < 81; k++) {
+            int code = k;
+            for(int a = 0; a < 4; a++) {
+                probe[a] = cell[a] + (code % 3) - 1;
+                code /= 3;
+            }
+            auto it = planes.find(PlaneKeyOf(probe));
+            if(it == planes.end()) continue;
+            for(int c : it->second) {
+                if(c > i) candidates.push_back(c);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                         candidates.end());
+        if(candidates.empty()) continue;
+
         SEdgeList sel = {};
         si->MakeEdgesInto(this, &sel, SSurface::MakeAs::XYZ);
 
@@ -29,7 +90,7 @@ void SShell::MergeCoincidentSurfaces() {
         do {
             mergedThisTime = false;
 
-            for(j = i + 1; j < surface.n; j++) {
+            for(int j : candidates) {
                 sj = &(surface.elem[j]);
                 if(sj->tag) continue;
                 if(!sj->CoincidentWith(si, /*sameNormal=*/true)) continue;
@@ -93,34 +93,106 @@ double SolveSpace::BernsteinDerivative(int k, int deg, double t)
     ssassert(false, "Unexpected degree of spline");
 }
 
-Vector SBezier::PointAt(double t) const {
+//-----------------------------------------------------------------------------
+// The same basis functions, but all of them for one degree at once, with the
+// degree known at compile time so that there's nothing left to branch on.
+// The arithmetic is exactly as above, so the results are bit for bit the
+// same.
+//-----------------------------------------------------------------------------
+template<int DEG> static inline void BernsteinBasis(double t, double *B);
+template<> inline void BernsteinBasis<0>(double t, double *B) {
+    B[0] = 1;
+}
+template<> inline void BernsteinBasis<1>(double t, double *B) {
+    B[0] = (1 - t);
+    B[1] = t;
+}
+template<> inline void BernsteinBasis<2>(double t, double *B) {
+    B[0] = (1 - t)*(1 - t);
+    B[1] = 2*(1 - t)*t;
+    B[2] = t*t;
+}
+template<> inline void BernsteinBasis<3>(double t, double *B) {
+    B[0] = (1 - t)*(1 - t)*(1 - t);
+    B[1] = 3*(1 - t)*(1 - t)*t;
+    B[2] = 3*(1 - t)*t*t;
+    B[3] = t*t*t;
+}
+
+template<int DEG> static inline void BernsteinDerivativeBasis(double t, double *B);
+template<> inline void BernsteinDerivativeBasis<0>(double t, double *B) {
+    B[0] = 0;
+}
+template<> inline void BernsteinDerivativeBasis<1>(double t, double *B) {
+    B[0] = -1;
+    B[1] = 1;
+}
+template<> inline void BernsteinDerivativeBasis<2>(double t, double *B) {
+    B[0] = -2 + 2*t;
+    B[1] = 2 - 4*t;
+    B[2] = 2*t;
+}
+template<> inline void BernsteinDerivativeBasis<3>(double t, double *B) {
+    B[0] = -3 + 6*t - 3*t*t;
+    B[1] = 3 - 12*t + 9*t*t;
+    B[2] = 6*t - 9*t*t;
+    B[3] = 3*t*t;
+}
+
+// For the batched evaluators, which branch on the degree once per sample.
+static void BernsteinBasis(int deg, double t, double *B) {
+    switch(deg) {
+        case 0: BernsteinBasis<0>(t, B); return;
+        case 1: BernsteinBasis<1>(t, B); return;
+        case 2: BernsteinBasis<2>(t, B); return;
+        case 3: BernsteinBasis<3>(t, B); return;
+    }
+    ssassert(false, "Unexpected degree of spline");
+}
+
+static void BernsteinDerivativeBasis(int deg, double t, double *B) {
+    switch(deg) {
+        case 0: BernsteinDerivativeBasis<0>(t, B); return;
+        case 1: BernsteinDerivativeBasis<1>(t, B); return;
+        case 2: BernsteinDerivativeBasis<2>(t, B); return;
+        case 3: BernsteinDerivativeBasis<3>(t, B); return;
+    }
+    ssassert(false, "Unexpected degree of spline");
+}
+
+//-----------------------------------------------------------------------------
+// Evaluators for a curve of fixed degree, with the loops unrolled; picked
+// from a table by degree.
+//-----------------------------------------------------------------------------
+template<int DEG>
+static Vector BezierPointAt(const SBezier *sb, double t) {
+    double B[DEG+1];
+    BernsteinBasis<DEG>(t, B);
+
     Vector pt = Vector::From(0, 0, 0);
     double d = 0;
-
-    int i;
-    for(i = 0; i <= deg; i++) {
-        double B = Bernstein(i, deg, t);
-        pt = pt.Plus(ctrl[i].ScaledBy(B*weight[i]));
-        d += weight[i]*B;
+    for(int i = 0; i <= DEG; i++) {
+        pt = pt.Plus(sb->ctrl[i].ScaledBy(B[i]*sb->weight[i]));
+        d += sb->weight[i]*B[i];
     }
     pt = pt.ScaledBy(1.0/d);
     return pt;
 }
 
-Vector SBezier::TangentAt(double t) const {
+template<int DEG>
+static Vector BezierTangentAt(const SBezier *sb, double t) {
+    double B[DEG+1], Bp[DEG+1];
+    BernsteinBasis<DEG>(t, B);
+    BernsteinDerivativeBasis<DEG>(t, Bp);
+
     Vector pt = Vector::From(0, 0, 0), pt_p = Vector::From(0, 0, 0);
     double d = 0, d_p = 0;
+    for(int i = 0; i <= DEG; i++) {
+        pt = pt.Plus(sb->ctrl[i].ScaledBy(B[i]*sb->weight[i]));
+        d += sb->weight[i]*B[i];
 
-    int i;
-    for(i = 0; i <= deg; i++) {
-        double B  = Bernstein(i, deg, t),
-               Bp = BernsteinDerivative(i, deg, t);
-
-        pt = pt.Plus(ctrl[i].ScaledBy(B*weight[i]));
-        d += weight[i]*B;
-
-        pt_p = pt_p.Plus(ctrl[i].ScaledBy(Bp*weight[i]));
-        d_p += weight[i]*Bp;
+        pt_p = pt_p.Plus(sb->ctrl[i].ScaledBy(Bp[i]*sb->weight[i]));
+        d_p += sb->weight[i]*Bp[i];
     }
 
     // quotient rule; f(t) = n(t)/d(t), so f' = (n'*d - n*d')/(d^2)
@@ -130,6 +202,24 @@ Vector SBezier::TangentAt(double t) const {
     return ret;
 }
 
+typedef Vector (*BezierEvalFn)(const SBezier *sb, double t);
+static const BezierEvalFn BezierPointAtFns[4] = {
+    BezierPointAt<0>, BezierPointAt<1>, BezierPointAt<2>, BezierPointAt<3>,
+};
+static const BezierEvalFn BezierTangentAtFns[4] = {
+    BezierTangentAt<0>, BezierTangentAt<1>, BezierTangentAt<2>, BezierTangentAt<3>,
+};
+
+Vector SBezier::PointAt(double t) const {
+    ssassert(deg >= 0 && deg <= 3, "Unexpected degree of spline");
+    return BezierPointAtFns[deg](this, t);
+}
+
+Vector SBezier::TangentAt(double t) const {
+    ssassert(deg >= 0 && deg <= 3, "Unexpected degree of spline");
+    return BezierTangentAtFns[deg](this, t);
+}
+
 void SBezier::ClosestPointTo(Vector p, double *t, bool mustConverge) const {
     int i;
     double minDist = VERY_POSITIVE;
@@ -257,11 +347,50 @@ void SBezier::MakePwlInto(SContour *sc, double chordTol) const {
     }
     lv.Clear();
 }
+//-----------------------------------------------------------------------------
+// The same curve tends to get linearized at the same tolerance many times
+// over in a single regeneration, so remember the results. The key is the
+// curve itself and everything that the subdivision depends on. Lines are
+// cheaper to linearize than to look up, so they're never cached.
+//-----------------------------------------------------------------------------
+static GeometryCache<std::vector<Vector>> PwlCache(1 << 20);
+
 void SBezier::MakePwlInto(List<Vector> *l, double chordTol) const {
     if(EXACT(chordTol == 0)) {
         // Use the default chord tolerance.
         chordTol = SS.ChordTolMm();
     }
+    if(deg == 1) {
+        MakePwlUncachedInto(l, chordTol);
+        return;
+    }
+
+    std::vector<double> key;
+    key.reserve(4*(deg + 1) + 3);
+    key.push_back(deg);
+    for(int i = 0; i <= deg; i++) {
+        key.push_back(ctrl[i].x);
+        key.push_back(ctrl[i].y);
+        key.push_back(ctrl[i].z);
+        key.push_back(weight[i]);
+    }
+    key.push_back(chordTol);
+    key.push_back(SS.GetMaxSegments());
+    bool found = PwlCache.Find(key, [&](const std::vector<Vector> &pts) {
+        for(const Vector &v : pts) {
+            l->Add(&v);
+        }
+    });
+    if(found) return;
+
+    int start = l->n;
+    MakePwlUncachedInto(l, chordTol);
+
+    std::vector<Vector> pts(l->elem + start, l->elem + l->n);
+    size_t cost = pts.size();
+    PwlCache.Insert(key, std::move(pts), cost);
+}
+void SBezier::MakePwlUncachedInto(List<Vector> *l, double chordTol) const {
     l->Add(&(ctrl[0]));
     if(deg == 1) {
         l->Add(&(ctrl[1]));
@@ -269,16 +398,21 @@ void SBezier::MakePwlInto(List<Vector> *l, double chordTol) const {
         // Never do fewer than one intermediate point; people seem to get
         // unhappy when their circles turn into squares, but maybe less
         // unhappy with octagons.
-        MakePwlInitialWorker(l, 0.0, 0.5, chordTol);
-        MakePwlInitialWorker(l, 0.5, 1.0, chordTol);
+        Vector p0 = PointAt(0.0), pm = PointAt(0.5), p1 = PointAt(1.0);
+        MakePwlInitialWorker(l, 0.0, 0.5, p0, pm, chordTol);
+        MakePwlInitialWorker(l, 0.5, 1.0, pm, p1, chordTol);
     }
 }
-void SBezier::MakePwlWorker(List<Vector> *l, double ta, double tb, double chordTol) const
+//-----------------------------------------------------------------------------
+// The workers are passed the points at the ends of their interval, since the
+// caller has always evaluated those already; so each level of subdivision
+// costs only the evaluation at the new midpoint.
+//-----------------------------------------------------------------------------
+void SBezier::MakePwlWorker(List<Vector> *l, double ta, double tb,
+                            Vector pa, Vector pb, double chordTol) const
 {
-    Vector pa = PointAt(ta);
-    Vector pb = PointAt(tb);
-
-    Vector pm = PointAt((ta + tb) / 2.0);
+    double tm = (ta + tb) / 2.0;
+    Vector pm = PointAt(tm);
     double d = pm.DistanceToLine(pa, pb.Minus(pa));
 
     double step = 1.0/SS.GetMaxSegments();
@@ -286,16 +420,13 @@ void SBezier::MakePwlWorker(List<Vector> *l, double ta, double tb, double chordT
         // A previous call has already added the beginning of our interval.
         l->Add(&pb);
     } else {
-        double tm = (ta + tb) / 2;
-        MakePwlWorker(l, ta, tm, chordTol);
-        MakePwlWorker(l, tm, tb, chordTol);
+        MakePwlWorker(l, ta, tm, pa, pm, chordTol);
+        MakePwlWorker(l, tm, tb, pm, pb, chordTol);
     }
 }
-void SBezier::MakePwlInitialWorker(List<Vector> *l, double ta, double tb, double chordTol) const
+void SBezier::MakePwlInitialWorker(List<Vector> *l, double ta, double tb,
+                                   Vector pa, Vector pb, double chordTol) const
 {
-    Vector pa = PointAt(ta);
-    Vector pb = PointAt(tb);
-
     double tm1 = ta + (tb - ta) * 0.25;
     double tm2 = ta + (tb - ta) * 0.5;
     double tm3 = ta + (tb - ta) * 0.75;
@@ -317,8 +448,8 @@ void SBezier::MakePwlInitialWorker(List<Vector> *l, double ta, double tb, double
         l->Add(&pb);
     } else {
         double tm = (ta + tb) / 2;
-        MakePwlWorker(l, ta, tm, chordTol);
-        MakePwlWorker(l, tm, tb, chordTol);
+        MakePwlWorker(l, ta, tm, pa, pm2, chordTol);
+        MakePwlWorker(l, tm, tb, pm2, pb, chordTol);
     }
 }
 
@@ -357,48 +488,60 @@ void SBezier::MakeNonrationalCubicInto(SBezierList *bl, double tolerance, int de
 Vector SSurface::PointAt(Point2d puv) const {
     return PointAt(puv.x, puv.y);
 }
-Vector SSurface::PointAt(double u, double v) const {
+//-----------------------------------------------------------------------------
+// Likewise for a surface, with both degrees fixed.
+//-----------------------------------------------------------------------------
+template<int DEGM, int DEGN>
+static Vector SurfacePointAt(const SSurface *srf, double u, double v) {
+    double Bu[DEGM+1], Bv[DEGN+1];
+    BernsteinBasis<DEGM>(u, Bu);
+    BernsteinBasis<DEGN>(v, Bv);
+
     Vector num = Vector::From(0, 0, 0);
     double den = 0;
+    for(int i = 0; i <= DEGM; i++) {
+        for(int j = 0; j <= DEGN; j++) {
+            double Bi = Bu[i], Bj = Bv[j], w = srf->weight[i][j];
 
-    int i, j;
-    for(i = 0; i <= degm; i++) {
-        for(j = 0; j <= degn; j++) {
-            double Bi = Bernstein(i, degm, u),
-                   Bj = Bernstein(j, degn, v);
-
-            num = num.Plus(ctrl[i][j].ScaledBy(Bi*Bj*weight[i][j]));
-            den += weight[i][j]*Bi*Bj;
+            num = num.Plus(srf->ctrl[i][j].ScaledBy(Bi*Bj*w));
+            den += w*Bi*Bj;
         }
     }
     num = num.ScaledBy(1.0/den);
     return num;
 }
 
-void SSurface::TangentsAt(double u, double v, Vector *tu, Vector *tv) const {
+template<int DEGM, int DEGN>
+static void SurfaceTangentsAt(const SSurface *srf, double u, double v,
+                              Vector *tu, Vector *tv)
+{
+    double Bu[DEGM+1], Bv[DEGN+1], Bup[DEGM+1], Bvp[DEGN+1];
+    BernsteinBasis<DEGM>(u, Bu);
+    BernsteinBasis<DEGN>(v, Bv);
+    BernsteinDerivativeBasis<DEGM>(u, Bup);
+    BernsteinDerivativeBasis<DEGN>(v, Bvp);
+
     Vector num   = Vector::From(0, 0, 0),
            num_u = Vector::From(0, 0, 0),
            num_v = Vector::From(0, 0, 0);
     double den   = 0,
            den_u = 0,
            den_v = 0;
+    for(int i = 0; i <= DEGM; i++) {
+        for(int j = 0; j <= DEGN; j++) {
+            double Bi  = Bu[i],  Bj  = Bv[j],
+                   Bip = Bup[i], Bjp = Bvp[j],
+                   w   = srf->weight[i][j];
+            Vector c = srf->ctrl[i][j];
 
-    int i, j;
-    for(i = 0; i <= degm; i++) {
-        for(j = 0; j <= degn; j++) {
-            double Bi  = Bernstein(i, degm, u),
-                   Bj  = Bernstein(j, degn, v),
-                   Bip = BernsteinDerivative(i, degm, u),
-                   Bjp = BernsteinDerivative(j, degn, v);
+            num = num.Plus(c.ScaledBy(Bi*Bj*w));
+            den += w*Bi*Bj;
 
-            num = num.Plus(ctrl[i][j].ScaledBy(Bi*Bj*weight[i][j]));
-            den += weight[i][j]*Bi*Bj;
+            num_u = num_u.Plus(c.ScaledBy(Bip*Bj*w));
+            den_u += w*Bip*Bj;
 
-            num_u = num_u.Plus(ctrl[i][j].ScaledBy(Bip*Bj*weight[i][j]));
-            den_u += weight[i][j]*Bip*Bj;
-
-            num_v = num_v.Plus(ctrl[i][j].ScaledBy(Bi*Bjp*weight[i][j]));
-            den_v += weight[i][j]*Bi*Bjp;
+            num_v = num_v.Plus(c.ScaledBy(Bi*Bjp*w));
+            den_v += w*Bi*Bjp;
         }
     }
     // quotient rule; f(t) = n(t)/d(t), so f' = (n'*d - n*d')/(d^2)
@@ -409,6 +552,35 @@ void SSurface::TangentsAt(double u, double v, Vector *tu, Vector *tv) const {
     *tv = tv->ScaledBy(1.0/(den*den));
 }
 
+typedef Vector (*SurfacePointAtFn)(const SSurface *srf, double u, double v);
+static const SurfacePointAtFn SurfacePointAtFns[4][4] = {
+    { SurfacePointAt<0,0>, SurfacePointAt<0,1>, SurfacePointAt<0,2>, SurfacePointAt<0,3> },
+    { SurfacePointAt<1,0>, SurfacePointAt<1,1>, SurfacePointAt<1,2>, SurfacePointAt<1,3> },
+    { SurfacePointAt<2,0>, SurfacePointAt<2,1>, SurfacePointAt<2,2>, SurfacePointAt<2,3> },
+    { SurfacePointAt<3,0>, SurfacePointAt<3,1>, SurfacePointAt<3,2>, SurfacePointAt<3,3> },
+};
+
+typedef void (*SurfaceTangentsAtFn)(const SSurface *srf, double u, double v,
+                                    Vector *tu, Vector *tv);
+static const SurfaceTangentsAtFn SurfaceTangentsAtFns[4][4] = {
+    { SurfaceTangentsAt<0,0>, SurfaceTangentsAt<0,1>, SurfaceTangentsAt<0,2>, SurfaceTangentsAt<0,3> },
+    { SurfaceTangentsAt<1,0>, SurfaceTangentsAt<1,1>, SurfaceTangentsAt<1,2>, SurfaceTangentsAt<1,3> },
+    { SurfaceTangentsAt<2,0>, SurfaceTangentsAt<2,1>, SurfaceTangentsAt<2,2>, SurfaceTangentsAt<2,3> },
+    { SurfaceTangentsAt<3,0>, SurfaceTangentsAt<3,1>, SurfaceTangentsAt<3,2>, SurfaceTangentsAt<3,3> },
+};
+
+Vector SSurface::PointAt(double u, double v) const {
+    ssassert(degm >= 0 && degm <= 3 && degn >= 0 && degn <= 3,
+             "Unexpected degree of surface");
+    return SurfacePointAtFns[degm][degn](this, u, v);
+}
+
+void SSurface::TangentsAt(double u, double v, Vector *tu, Vector *tv) const {
+    ssassert(degm >= 0 && degm <= 3 && degn >= 0 && degn <= 3,
+             "Unexpected degree of surface");
+    SurfaceTangentsAtFns[degm][degn](this, u, v, tu, tv);
+}
+
 Vector SSurface::NormalAt(Point2d puv) const {
     return NormalAt(puv.x, puv.y);
 }
@@ -419,6 +591,277 @@ Vector SSurface::NormalAt(double u, double v) const {
     return tu.Cross(tv);
 }
 
+//-----------------------------------------------------------------------------
+// Evaluate the surface at many (u, v) at once. We tabulate the basis
+// functions for each point up front, and then accumulate over the control
+// points with the samples innermost, so that the compiler can run several
+// of them side by side. The sums are formed in exactly the same order as
+// in PointAt and TangentsAt, so the results are bit for bit the same.
+//-----------------------------------------------------------------------------
+static const int EVAL_BATCH = 64;
+
+void SSurface::PointsAt(const Point2d *puv, int n, Vector *pts) const {
+    double Bu[4][EVAL_BATCH], Bv[4][EVAL_BATCH];
+    double x[EVAL_BATCH], y[EVAL_BATCH], z[EVAL_BATCH], den[EVAL_BATCH];
+
+    for(int s = 0; s < n; s += EVAL_BATCH) {
+        int cnt = min(EVAL_BATCH, n - s);
+        for(int k = 0; k < cnt; k++) {
+            double bu[4], bv[4];
+            BernsteinBasis(degm, puv[s+k].x, bu);
+            BernsteinBasis(degn, puv[s+k].y, bv);
+            for(int i = 0; i <= degm; i++) Bu[i][k] = bu[i];
+            for(int j = 0; j <= degn; j++) Bv[j][k] = bv[j];
+            x[k] = y[k] = z[k] = den[k] = 0;
+        }
+
+        for(int i = 0; i <= degm; i++) {
+            for(int j = 0; j <= degn; j++) {
+                Vector c = ctrl[i][j];
+                double w = weight[i][j];
+                const double *bi = Bu[i], *bj = Bv[j];
+                for(int k = 0; k < cnt; k++) {
+                    double B = bi[k]*bj[k]*w;
+                    x[k] += c.x*B;
+                    y[k] += c.y*B;
+                    z[k] += c.z*B;
+                    den[k] += w*bi[k]*bj[k];
+                }
+            }
+        }
+
+        for(int k = 0; k < cnt; k++) {
+            pts[s+k] = Vector::From(x[k], y[k], z[k]).ScaledBy(1.0/den[k]);
+        }
+    }
+}
+
+void SSurface::NormalsAt(const Point2d *puv, int n, Vector *normals) const {
+    double Bu[4][EVAL_BATCH], Bv[4][EVAL_BATCH],
+           Bup[4][EVAL_BATCH], Bvp[4][EVAL_BATCH];
+    Vector num[EVAL_BATCH], num_u[EVAL_BATCH], num_v[EVAL_BATCH];
+    double den[EVAL_BATCH], den_u[EVAL_BATCH], den_v[EVAL_BATCH];
+
+    for(int s = 0; s < n; s += EVAL_BATCH) {
+        int cnt = min(EVAL_BATCH, n - s);
+        for(int k = 0; k < cnt; k++) {
+            double u = puv[s+k].x, v = puv[s+k].y;
+            double bu[4], bv[4], bup[4], bvp[4];
+            BernsteinBasis(degm, u, bu);
+            BernsteinBasis(degn, v, bv);
+            BernsteinDerivativeBasis(degm, u, bup);
+            BernsteinDerivativeBasis(degn, v, bvp);
+            for(int i = 0; i <= degm; i++) {
+                Bu[i][k]  = bu[i];
+                Bup[i][k] = bup[i];
+            }
+            for(int j = 0; j <= degn; j++) {
+                Bv[j][k]  = bv[j];
+                Bvp[j][k] = bvp[j];
+            }
+            num[k] = num_u[k] = num_v[k] = Vector::From(0, 0, 0);
+            den[k] = den_u[k] = den_v[k] = 0;
+        }
+
+        for(int i = 0; i <= degm; i++) {
+            for(int j = 0; j <= degn; j++) {
+                Vector c = ctrl[i][j];
+                double w = weight[i][j];
+                for(int k = 0; k < cnt; k++) {
+                    double Bi  = Bu[i][k],  Bj  = Bv[j][k],
+                           Bip = Bup[i][k], Bjp = Bvp[j][k];
+
+                    num[k] = num[k].Plus(c.ScaledBy(Bi*Bj*w));
+                    den[k] += w*Bi*Bj;
+
+                    num_u[k] = num_u[k].Plus(c.ScaledBy(Bip*Bj*w));
+                    den_u[k] += w*Bip*Bj;
+
+                    num_v[k] = num_v[k].Plus(c.ScaledBy(Bi*Bjp*w));
+                    den_v[k] += w*Bi*Bjp;
+                }
+            }
+        }
+
+        for(int k = 0; k < cnt; k++) {
+            // quotient rule, as in TangentsAt for a single point
+            Vector tu, tv;
+            tu = ((num_u[k].ScaledBy(den[k])).Minus(num[k].ScaledBy(den_u[k])));
+            tu = tu.ScaledBy(1.0/(den[k]*den[k]));
+
+            tv = ((num_v[k].ScaledBy(den[k])).Minus(num[k].ScaledBy(den_v[k])));
+            tv = tv.ScaledBy(1.0/(den[k]*den[k]));
+
+            normals[s+k] = tu.Cross(tv);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// The (u, v) where we last finished Newton iterations to project a point into
+// a surface, to use as the initial guess next time. This is kept per thread
+// (since the Boolean projects into the same surfaces from several threads at
+// once) in a small table indexed by the surface's address; a collision just
+// costs us a worse guess.
+//-----------------------------------------------------------------------------
+struct ClosestPointSeed {
+    const SSurface *srf;
+    Point2d         uv;
+};
+static const int SEED_TABLE_SIZE = 64;
+static thread_local ClosestPointSeed SeedTable[SEED_TABLE_SIZE];
+
+static ClosestPointSeed *SeedFor(const SSurface *srf) {
+    uintptr_t i = ((uintptr_t)srf / sizeof(SSurface)) % SEED_TABLE_SIZE;
+    ClosestPointSeed *seed = &SeedTable[i];
+    if(seed->srf != srf) {
+        seed->srf  = srf;
+        seed->uv   = Point2d::From(0, 0);
+    }
+    return seed;
+}
+
+//-----------------------------------------------------------------------------
+// When that guess doesn't work, we look for the nearest of a set of samples
+// on the surface. Those are the centers of the patches that we get by
+// repeatedly splitting the surface in half, alternately in u and v, so they
+// form a tree; and each patch lies within the bounding box of its control
+// points, so we can skip any subtree whose box is farther away than the best
+// sample yet. Building that costs as much as a few searches by brute force,
+// so the trees are cached by the surface's geometry, for all the threads.
+//-----------------------------------------------------------------------------
+class ClosestPointTree {
+public:
+    struct Node {
+        Vector  max, min;
+        Point2d uv;
+        Vector  p;
+        int     child[2];
+    };
+    std::vector<Node> node;
+
+    void Build(const SSurface *srf);
+    int BuildBelow(const SSurface *srf, SSurface *patch,
+                   double u0, double u1, double v0, double v1,
+                   int depth, int maxDepth);
+    void NearestBelow(int n, Vector p, double *best, Point2d *uv) const;
+};
+
+void ClosestPointTree::Build(const SSurface *srf) {
+    // As many samples as the old uniform grid, about.
+    int levels = (max(srf->degm, srf->degn) == 2) ? 3 : 4;
+
+    SSurface patch = {};
+    patch.degm = srf->degm;
+    patch.degn = srf->degn;
+    for(int i = 0; i <= srf->degm; i++) {
+        for(int j = 0; j <= srf->degn; j++) {
+            patch.ctrl[i][j]   = srf->ctrl[i][j];
+            patch.weight[i][j] = srf->weight[i][j];
+        }
+    }
+    node.reserve((size_t)2 << (2*levels));
+    BuildBelow(srf, &patch, 0, 1, 0, 1, 0, 2*levels);
+}
+
+int ClosestPointTree::BuildBelow(const SSurface *srf, SSurface *patch,
+                                 double u0, double u1, double v0, double v1,
+                                 int depth, int maxDepth)
+{
+    int n = (int)node.size();
+    node.push_back({});
+
+    Node nd = {};
+    patch->GetAxisAlignedBounding(&nd.max, &nd.min);
+    nd.uv = Point2d::From((u0 + u1)/2, (v0 + v1)/2);
+    nd.p  = srf->PointAt(nd.uv);
+    nd.child[0] = nd.child[1] = -1;
+    if(depth < maxDepth) {
+        bool byU = (depth % 2 == 0);
+        SSurface pa = {}, pb = {};
+        patch->SplitInHalf(byU, &pa, &pb);
+        if(byU) {
+            double um = (u0 + u1)/2;
+            nd.child[0] = BuildBelow(srf, &pa, u0, um, v0, v1, depth + 1, maxDepth);
+            nd.child[1] = BuildBelow(srf, &pb, um, u1, v0, v1, depth + 1, maxDepth);
+        } else {
+            double vm = (v0 + v1)/2;
+            nd.child[0] = BuildBelow(srf, &pa, u0, u1, v0, vm, depth + 1, maxDepth);
+            nd.child[1] = BuildBelow(srf, &pb, u0, u1, vm, v1, depth + 1, maxDepth);
+        }
+    }
+    // Recursing can reallocate the node list, so fill this in last.
+    node[n] = nd;
+    return n;
+}
+
+static double DistanceToBox(Vector p, Vector bmax, Vector bmin) {
+    double d2 = 0;
+    for(int i = 0; i < 3; i++) {
+        double pi = p.Element(i), d = 0;
+        if(pi > bmax.Element(i)) {
+            d = pi - bmax.Element(i);
+        } else if(pi < bmin.Element(i)) {
+            d = bmin.Element(i) - pi;
+        }
+        d2 += d*d;
+    }
+    return sqrt(d2);
+}
+
+void ClosestPointTree::NearestBelow(int n, Vector p,
+                                    double *best, Point2d *uv) const
+{
+    const Node *nd = &node[n];
+    if(DistanceToBox(p, nd->max, nd->min) >= *best) return;
+
+    double d = (nd->p).Minus(p).Magnitude();
+    if(d < *best) {
+        *best = d;
+        *uv = nd->uv;
+    }
+    if(nd->child[0] < 0) return;
+
+    // Visit the nearer child first, so that we can prune more of the other.
+    int c0 = nd->child[0], c1 = nd->child[1];
+    if(DistanceToBox(p, node[c1].max, node[c1].min) <
+       DistanceToBox(p, node[c0].max, node[c0].min))
+    {
+        swap(c0, c1);
+    }
+    NearestBelow(c0, p, best, uv);
+    NearestBelow(c1, p, best, uv);
+}
+
+// Limited by the total number of nodes, about 100 bytes each.
+static GeometryCache<std::shared_ptr<const ClosestPointTree>>
+    ClosestPointTrees(1 << 20);
+
+static std::shared_ptr<const ClosestPointTree> TreeFor(const SSurface *srf) {
+    std::vector<double> key;
+    key.reserve(4*(srf->degm + 1)*(srf->degn + 1) + 2);
+    key.push_back(srf->degm);
+    key.push_back(srf->degn);
+    for(int i = 0; i <= srf->degm; i++) {
+        for(int j = 0; j <= srf->degn; j++) {
+            key.push_back(srf->ctrl[i][j].x);
+            key.push_back(srf->ctrl[i][j].y);
+            key.push_back(srf->ctrl[i][j].z);
+            key.push_back(srf->weight[i][j]);
+        }
+    }
+    std::shared_ptr<const ClosestPointTree> cached;
+    ClosestPointTrees.Find(key, [&](const std::shared_ptr<const ClosestPointTree> &t) {
+        cached = t;
+    });
+    if(cached) return cached;
+
+    std::shared_ptr<ClosestPointTree> tree = std::make_shared<ClosestPointTree>();
+    tree->Build(srf);
+    ClosestPointTrees.Insert(key, tree, tree->node.size());
+    return tree;
+}
+
 void SSurface::ClosestPointTo(Vector p, Point2d *puv, bool mustConverge) {
     ClosestPointTo(p, &(puv->x), &(puv->y), mustConverge);
 }
@@ -450,36 +893,27 @@ void SSurface::ClosestPointTo(Vector p, double *u, double *v, bool mustConverge)
     // good if we're working our way along a curve or something else where
     // we project successive points that are close to each other; something
     // like a 20% speedup empirically.
+    ClosestPointSeed *seed = SeedFor(this);
     if(mustConverge) {
-        double ut = cached.x, vt = cached.y;
+        double ut = seed->uv.x, vt = seed->uv.y;
         if(ClosestPointNewton(p, &ut, &vt, mustConverge)) {
-            cached.x = *u = ut;
-            cached.y = *v = vt;
+            seed->uv.x = *u = ut;
+            seed->uv.y = *v = vt;
             return;
         }
     }
 
     // Search for a reasonable initial guess
-    int i, j;
+    std::shared_ptr<const ClosestPointTree> tree = TreeFor(this);
     double minDist = VERY_POSITIVE;
-    int res = (max(degm, degn) == 2) ? 7 : 20;
-    for(i = 0; i < res; i++) {
-        for(j = 0; j < res; j++) {
-            double tryu = (i + 0.5)/res, tryv = (j + 0.5)/res;
-
-            Vector tryp = PointAt(tryu, tryv);
-            double d = (tryp.Minus(p)).Magnitude();
-            if(d < minDist) {
-                *u = tryu;
-                *v = tryv;
-                minDist = d;
-            }
-        }
-    }
+    Point2d guess = Point2d::From(0.5, 0.5);
+    tree->NearestBelow(0, p, &minDist, &guess);
+    *u = guess.x;
+    *v = guess.y;
 
     if(ClosestPointNewton(p, u, v, mustConverge)) {
-        cached.x = *u;
-        cached.y = *v;
+        seed->uv.x = *u;
+        seed->uv.y = *v;
         return;
     }
 
@@ -552,22 +986,41 @@ bool SSurface::PointIntersectingLine(Vector p0, Vector p1, double *u, double *v)
 
 Vector SSurface::ClosestPointOnThisAndSurface(SSurface *srf2, Vector p) {
     // This is untested.
-    int i, j;
-    Point2d puv[2];
-    SSurface *srf[2] = { this, srf2 };
+    Point2d puv, puv2;
+    ClosestPointTo(p, &puv, /*mustConverge=*/false);
+    srf2->ClosestPointTo(p, &puv2, /*mustConverge=*/false);
 
-    for(j = 0; j < 2; j++) {
-        (srf[j])->ClosestPointTo(p, &(puv[j]), /*mustConverge=*/false);
+    Vector pc;
+    if(!ClosestPointOnThisAndSurface(srf2, p, &puv, &puv2, &pc)) {
+        dbp("this and srf, didn't converge, d=%g",
+            (puv.Minus(puv2)).Magnitude());
     }
+    return pc;
+}
+
+//-----------------------------------------------------------------------------
+// The same, but starting from the given guesses for the (u, v) on this
+// surface and on srf2, and returning the (u, v) that we converge to; so a
+// caller that's walking along the intersection can start close, and skip
+// projecting p into both surfaces from scratch. Returns false if we didn't
+// converge.
+//-----------------------------------------------------------------------------
+bool SSurface::ClosestPointOnThisAndSurface(SSurface *srf2, Vector p,
+                                            Point2d *puv0, Point2d *puv1,
+                                            Vector *pcl)
+{
+    int i, j;
+    Point2d *puv[2] = { puv0, puv1 };
+    SSurface *srf[2] = { this, srf2 };
 
     for(i = 0; i < 10; i++) {
         Vector tu[2], tv[2], cp[2], n[2];
         double d[2];
 
         for(j = 0; j < 2; j++) {
-            (srf[j])->TangentsAt(puv[j].x, puv[j].y, &(tu[j]), &(tv[j]));
+            (srf[j])->TangentsAt(puv[j]->x, puv[j]->y, &(tu[j]), &(tv[j]));
 
-            cp[j] = (srf[j])->PointAt(puv[j]);
+            cp[j] = (srf[j])->PointAt(*puv[j]);
 
             n[j] = ((tu[j]).Cross(tv[j])).WithMagnitude(1);
             d[j] = (n[j]).Dot(cp[j]);
@@ -584,18 +1037,15 @@ Vector SSurface::ClosestPointOnThisAndSurface(SSurface *srf2, Vector p) {
         for(j = 0; j < 2; j++) {
             Vector dc = pc.Minus(cp[j]);
             double du = dc.Dot(tu[j]), dv = dc.Dot(tv[j]);
-            puv[j].x += du / ((tu[j]).MagSquared());
-            puv[j].y += dv / ((tv[j]).MagSquared());
+            puv[j]->x += du / ((tu[j]).MagSquared());
+            puv[j]->y += dv / ((tv[j]).MagSquared());
         }
     }
-    if(i >= 10) {
-        dbp("this and srf, didn't converge, d=%g",
-            (puv[0].Minus(puv[1])).Magnitude());
-    }
 
     // If this converged, then the two points are actually equal.
-    return ((srf[0])->PointAt(puv[0])).Plus(
-           ((srf[1])->PointAt(puv[1]))).ScaledBy(0.5);
+    *pcl = ((srf[0])->PointAt(*puv[0])).Plus(
+           ((srf[1])->PointAt(*puv[1]))).ScaledBy(0.5);
+    return (i < 10);
 }
 
 void SSurface::PointOnSurfaces(SSurface *s1, SSurface *s2, double *up, double *vp)
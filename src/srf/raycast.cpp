@@ -379,12 +379,55 @@ void SSurface::AllPointsIntersecting(Vector a, Vector b,
     inters.Clear();
 }
 
+//-----------------------------------------------------------------------------
+// Find the surfaces whose bounding boxes the line (or segment) through a and
+// b might pass through, in the order that they appear in the shell. That's
+// every surface, unless we've got a BVH from MakeClassifyingBsps.
+//-----------------------------------------------------------------------------
+void SShell::SurfacesNearLine(Vector a, Vector b, bool asSegment,
+                              std::vector<SSurface *> *srfs)
+{
+    srfs->clear();
+    if(surfaceBvh.IsEmpty()) {
+        for(SSurface &ss : surface) {
+            srfs->push_back(&ss);
+        }
+    } else {
+        std::vector<const SSurfaceBvh::Item *> found;
+        surfaceBvh.ItemsNearLine(a, b, asSegment, &found);
+        for(const SSurfaceBvh::Item *it : found) {
+            srfs->push_back(it->srf);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Likewise, find the surfaces whose bounding boxes overlap the given box.
+//-----------------------------------------------------------------------------
+void SShell::SurfacesNearBox(Vector bmax, Vector bmin,
+                             std::vector<SSurface *> *srfs)
+{
+    srfs->clear();
+    if(surfaceBvh.IsEmpty()) {
+        for(SSurface &ss : surface) {
+            srfs->push_back(&ss);
+        }
+    } else {
+        std::vector<const SSurfaceBvh::Item *> found;
+        surfaceBvh.ItemsNearBox(bmax, bmin, &found);
+        for(const SSurfaceBvh::Item *it : found) {
+            srfs->push_back(it->srf);
+        }
+    }
+}
+
 void SShell::AllPointsIntersecting(Vector a, Vector b,
                                    List<SInter> *il,
                                    bool asSegment, bool trimmed, bool inclTangent)
 {
-    SSurface *ss;
-    for(ss = surface.First(); ss; ss = surface.NextAfter(ss)) {
+    std::vector<SSurface *> srfs;
+    SurfacesNearLine(a, b, asSegment, &srfs);
+    for(SSurface *ss : srfs) {
         ss->AllPointsIntersecting(a, b, il,
             asSegment, trimmed, inclTangent);
     }
@@ -428,37 +471,64 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
 {
     List<SInter> l = {};
 
-    srand(0);
+    // Our own generator rather than rand(), so that the rays that we cast
+    // don't depend on whatever else is classifying edges on other threads.
+    std::minstd_rand rng(1);
+
+    // The trim edges that could possibly touch our edge; those have to share
+    // an endpoint with it, or contain p. That's every edge of every surface
+    // if we don't have a BVH over them.
+    std::vector<std::pair<SSurface *, SEdge *>> nearEdges;
+    if(edgeBvh.IsEmpty()) {
+        for(SSurface &ss : surface) {
+            for(SEdge &se : ss.edges.l) {
+                nearEdges.emplace_back(&ss, &se);
+            }
+        }
+    } else {
+        Vector emax = ea, emin = ea;
+        eb.MakeMaxMin(&emax, &emin);
+        p.MakeMaxMin(&emax, &emin);
+        Vector eps = Vector::From(LENGTH_EPS, LENGTH_EPS, LENGTH_EPS);
+        std::vector<const SSurfaceBvh::Item *> found;
+        edgeBvh.ItemsNearBox(emax.Plus(eps), emin.Minus(eps), &found);
+        for(const SSurfaceBvh::Item *it : found) {
+            nearEdges.emplace_back(it->srf, &(it->srf->edges.l.elem[it->edge]));
+        }
+    }
 
     // First, check for edge-on-edge
     int edge_inters = 0;
     Vector inter_surf_n[2], inter_edge_n[2];
-    SSurface *srf;
-    for(srf = surface.First(); srf; srf = surface.NextAfter(srf)) {
-        if(srf->LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true)) continue;
-
-        SEdgeList *sel = &(srf->edges);
-        SEdge *se;
-        for(se = sel->l.First(); se; se = sel->l.NextAfter(se)) {
-            if((ea.Equals(se->a) && eb.Equals(se->b)) ||
-               (eb.Equals(se->a) && ea.Equals(se->b)) ||
-                p.OnLineSegment(se->a, se->b))
-            {
-                if(edge_inters < 2) {
-                    // Edge-on-edge case
-                    Point2d pm;
-                    srf->ClosestPointTo(p,  &pm, /*mustConverge=*/false);
-                    // A vector normal to the surface, at the intersection point
-                    inter_surf_n[edge_inters] = srf->NormalAt(pm);
-                    // A vector normal to the intersecting edge (but within the
-                    // intersecting surface) at the intersection point, pointing
-                    // out.
-                    inter_edge_n[edge_inters] =
-                      (inter_surf_n[edge_inters]).Cross((se->b).Minus((se->a)));
-                }
+    SSurface *srf, *lastSrf = NULL;
+    bool lastOutside = false;
+    for(const auto &near : nearEdges) {
+        srf = near.first;
+        if(srf != lastSrf) {
+            lastSrf = srf;
+            lastOutside = srf->LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true);
+        }
+        if(lastOutside) continue;
 
-                edge_inters++;
+        SEdge *se = near.second;
+        if((ea.Equals(se->a) && eb.Equals(se->b)) ||
+           (eb.Equals(se->a) && ea.Equals(se->b)) ||
+            p.OnLineSegment(se->a, se->b))
+        {
+            if(edge_inters < 2) {
+                // Edge-on-edge case
+                Point2d pm;
+                srf->ClosestPointTo(p,  &pm, /*mustConverge=*/false);
+                // A vector normal to the surface, at the intersection point
+                inter_surf_n[edge_inters] = srf->NormalAt(pm);
+                // A vector normal to the intersecting edge (but within the
+                // intersecting surface) at the intersection point, pointing
+                // out.
+                inter_edge_n[edge_inters] =
+                  (inter_surf_n[edge_inters]).Cross((se->b).Minus((se->a)));
             }
+
+            edge_inters++;
         }
     }
 
@@ -519,7 +589,9 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
     // are on surface) and for numerical stability, so we don't pick up
     // the additional error from the line intersection.
 
-    for(srf = surface.First(); srf; srf = surface.NextAfter(srf)) {
+    std::vector<SSurface *> srfs;
+    SurfacesNearLine(ea, eb, /*asSegment=*/true, &srfs);
+    for(SSurface *srf : srfs) {
         if(srf->LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true)) continue;
 
         Point2d puv;
@@ -551,7 +623,8 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
         // Cast a ray in a random direction (two-sided so that we test if
         // the point lies on a surface, but use only one side for in/out
         // testing)
-        Vector ray = Vector::From(Random(1), Random(1), Random(1));
+        Vector ray = Vector::From((double)rng(), (double)rng(), (double)rng());
+        ray = ray.ScaledBy(1.0 / std::minstd_rand::max());
 
         AllPointsIntersecting(
             p.Minus(ray), p.Plus(ray), &l,
@@ -603,6 +676,7 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
         if(cnt++ > 5) {
             dbp("can't find a ray that doesn't hit on edge!");
             dbp("on edge = %d, edge_inters = %d", onEdge, edge_inters);
+            std::lock_guard<std::mutex> lock(SS.nakedEdgesMutex);
             SS.nakedEdges.AddEdge(ea, eb);
             break;
         }
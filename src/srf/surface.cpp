@@ -51,6 +51,31 @@ bool SSurface::IsExtrusion(SBezier *of, Vector *alongp) const {
     return true;
 }
 
+//-----------------------------------------------------------------------------
+// Some surfaces are surfaces of extrusion along u instead of v; like the side
+// of a cylinder made by revolving a line about a parallel axis, which is a
+// line swept along an arc. For those, return a copy of the geometry (without
+// any trim) with u and v swapped, for which IsExtrusion is true.
+//-----------------------------------------------------------------------------
+bool SSurface::IsExtrusionAlongU(SSurface *swapped) const {
+    if(degm != 1) return false;
+
+    SSurface ret = {};
+    ret.h    = h;
+    ret.degm = degn;
+    ret.degn = degm;
+    for(int i = 0; i <= degm; i++) {
+        for(int j = 0; j <= degn; j++) {
+            ret.ctrl[j][i]   = ctrl[i][j];
+            ret.weight[j][i] = weight[i][j];
+        }
+    }
+    if(!ret.IsExtrusion(NULL, NULL)) return false;
+
+    *swapped = ret;
+    return true;
+}
+
 bool SSurface::IsCylinder(Vector *axis, Vector *center, double *r,
                             Vector *start, Vector *finish) const
 {
@@ -414,7 +439,91 @@ void SSurface::MakeSectionEdgesInto(SShell *shell, SEdgeList *sel, SBezierList *
     }
 }
 
+size_t DoubleKeyHash::operator()(const std::vector<double> &key) const {
+    size_t h = key.size();
+    for(double d : key) {
+        h ^= std::hash<double>()(d) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+static std::vector<GeometryCacheBase *> &GeometryCaches() {
+    static std::vector<GeometryCacheBase *> caches;
+    return caches;
+}
+
+GeometryCacheBase::GeometryCacheBase() {
+    GeometryCaches().push_back(this);
+}
+
+GeometryCacheBase::~GeometryCacheBase() {
+    std::vector<GeometryCacheBase *> &caches = GeometryCaches();
+    caches.erase(std::remove(caches.begin(), caches.end(), this), caches.end());
+}
+
+void GeometryCacheBase::ClearAll() {
+    for(GeometryCacheBase *cache : GeometryCaches()) {
+        cache->Clear();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// A cache of the triangles generated for each surface, so that surfaces
+// that come through a regeneration unchanged needn't be triangulated again.
+// The key is everything that the triangulation depends on: the surface
+// itself, its trim curves in xyz, and the chord tolerance.
+//-----------------------------------------------------------------------------
+static GeometryCache<std::vector<STriangle>> TriangulationCache(1 << 18);
+
+void SSurface::MakeTriangulationKey(SShell *shell, std::vector<double> *key) {
+    key->clear();
+    key->push_back(degm);
+    key->push_back(degn);
+    for(int i = 0; i <= degm; i++) {
+        for(int j = 0; j <= degn; j++) {
+            key->push_back(ctrl[i][j].x);
+            key->push_back(ctrl[i][j].y);
+            key->push_back(ctrl[i][j].z);
+            key->push_back(weight[i][j]);
+        }
+    }
+    key->push_back(face);
+    key->push_back(color.ToPackedInt());
+    key->push_back(SS.ChordTolMm());
+    key->push_back(SS.GetMaxSegments());
+
+    SEdgeList el = {};
+    MakeEdgesInto(shell, &el, MakeAs::XYZ);
+    for(const SEdge &se : el.l) {
+        key->push_back(se.a.x);
+        key->push_back(se.a.y);
+        key->push_back(se.a.z);
+        key->push_back(se.b.x);
+        key->push_back(se.b.y);
+        key->push_back(se.b.z);
+    }
+    el.Clear();
+}
+
 void SSurface::TriangulateInto(SShell *shell, SMesh *sm) {
+    std::vector<double> key;
+    MakeTriangulationKey(shell, &key);
+    bool found = TriangulationCache.Find(key, [&](const std::vector<STriangle> &tris) {
+        for(const STriangle &st : tris) {
+            sm->l.Add(&st);
+        }
+    });
+    if(found) return;
+
+    int start = sm->l.n;
+    TriangulateUncachedInto(shell, sm);
+
+    std::vector<STriangle> tris(sm->l.elem + start, sm->l.elem + sm->l.n);
+    size_t cost = tris.size();
+    TriangulationCache.Insert(key, std::move(tris), cost);
+}
+
+void SSurface::TriangulateUncachedInto(SShell *shell, SMesh *sm) {
     SEdgeList el = {};
 
     MakeEdgesInto(shell, &el, MakeAs::UV);
@@ -438,16 +547,28 @@ void SSurface::TriangulateInto(SShell *shell, SMesh *sm) {
             poly.UvGridTriangulateInto(sm, this);
         }
 
+        // Map all the vertices from uv into xyz in one batch.
+        int n = 3*(sm->l.n - start);
+        std::vector<Point2d> puv(n);
+        std::vector<Vector> pts(n), normals(n);
+        for(i = start; i < sm->l.n; i++) {
+            STriangle *st = &(sm->l.elem[i]);
+            for(int k = 0; k < 3; k++) {
+                puv[3*(i - start) + k] =
+                    Point2d::From(st->vertices[k].x, st->vertices[k].y);
+            }
+        }
+        PointsAt(puv.data(), n, pts.data());
+        NormalsAt(puv.data(), n, normals.data());
+
         STriMeta meta = { face, color };
         for(i = start; i < sm->l.n; i++) {
             STriangle *st = &(sm->l.elem[i]);
             st->meta = meta;
-            st->an = NormalAt(st->a.x, st->a.y);
-            st->bn = NormalAt(st->b.x, st->b.y);
-            st->cn = NormalAt(st->c.x, st->c.y);
-            st->a = PointAt(st->a.x, st->a.y);
-            st->b = PointAt(st->b.x, st->b.y);
-            st->c = PointAt(st->c.x, st->c.y);
+            for(int k = 0; k < 3; k++) {
+                st->normals[k]  = normals[3*(i - start) + k];
+                st->vertices[k] = pts[3*(i - start) + k];
+            }
             // Works out that my chosen contour direction is inconsistent with
             // the triangle direction, sigh.
             st->FlipNormal();
@@ -499,6 +620,13 @@ typedef struct {
     hSSurface   hs;
 } TrimLine;
 
+// The surface and curves generated by extruding one curve of the profile.
+struct ExtrudedSide {
+    SSurface    ss;
+    SCurve      sc0, sc1;   // the curve translated by t0 and t1
+    SCurve      line;       // from t0 to t1 at the curve's finish
+};
+
 void SShell::MakeFromExtrusionOf(SBezierLoopSet *sbls, Vector t0, Vector t1, RgbaColor color)
 {
     // Make the extrusion direction consistent with respect to the normal
@@ -533,33 +661,60 @@ void SShell::MakeFromExtrusionOf(SBezierLoopSet *sbls, Vector t0, Vector t1, Rgb
               hs1 = surface.AddAndAssignId(&s1);
 
     // Now go through the input curves. For each one, generate its surface
-    // of extrusion, its two translated trim curves, and one trim line. We
-    // go through by loops so that we can assign the lines correctly.
+    // of extrusion, its two translated trim curves, and one trim line. Each
+    // curve's are independent of the others', so we make them on several
+    // threads, and then add them in order so that they get the same handles
+    // regardless.
     SBezierLoop *sbl;
+    std::vector<SBezier *> sbs;
+    for(sbl = sbls->l.First(); sbl; sbl = sbls->l.NextAfter(sbl)) {
+        for(SBezier &sb : sbl->l) {
+            sbs.push_back(&sb);
+        }
+    }
+    std::vector<ExtrudedSide> sides(sbs.size());
+    ParallelFor((int)sbs.size(), [&](int i) {
+        SBezier *sb = sbs[i];
+        ExtrudedSide *side = &sides[i];
+
+        side->ss = SSurface::FromExtrusionOf(sb, t0, t1);
+        side->ss.color = color;
+
+        side->sc0 = {};
+        side->sc0.isExact = true;
+        side->sc0.exact = sb->TransformedBy(t0, Quaternion::IDENTITY, 1.0);
+        (side->sc0.exact).MakePwlInto(&(side->sc0.pts));
+
+        side->sc1 = {};
+        side->sc1.isExact = true;
+        side->sc1.exact = sb->TransformedBy(t1, Quaternion::IDENTITY, 1.0);
+        (side->sc1.exact).MakePwlInto(&(side->sc1.pts));
+
+        Vector pt = sb->Finish();
+        side->line = {};
+        side->line.isExact = true;
+        side->line.exact = SBezier::From(pt.Plus(t0), pt.Plus(t1));
+        (side->line.exact).MakePwlInto(&(side->line.pts));
+    });
+
+    // We go through by loops so that we can assign the lines correctly.
+    size_t k = 0;
     for(sbl = sbls->l.First(); sbl; sbl = sbls->l.NextAfter(sbl)) {
-        SBezier *sb;
         List<TrimLine> trimLines = {};
 
-        for(sb = sbl->l.First(); sb; sb = sbl->l.NextAfter(sb)) {
-            // Generate the surface of extrusion of this curve, and add
-            // it to the list
-            SSurface ss = SSurface::FromExtrusionOf(sb, t0, t1);
-            ss.color = color;
-            hSSurface hsext = surface.AddAndAssignId(&ss);
-
-            // Translate the curve by t0 and t1 to produce two trim curves
-            SCurve sc = {};
-            sc.isExact = true;
-            sc.exact = sb->TransformedBy(t0, Quaternion::IDENTITY, 1.0);
-            (sc.exact).MakePwlInto(&(sc.pts));
+        for(int m = 0; m < sbl->l.n; m++) {
+            ExtrudedSide *side = &sides[k++];
+
+            // Add the surface of extrusion of this curve to the list
+            hSSurface hsext = surface.AddAndAssignId(&(side->ss));
+
+            // And the curve translated by t0 and t1, as two trim curves
+            SCurve sc = side->sc0;
             sc.surfA = hs0;
             sc.surfB = hsext;
             hSCurve hc0 = curve.AddAndAssignId(&sc);
 
-            sc = {};
-            sc.isExact = true;
-            sc.exact = sb->TransformedBy(t1, Quaternion::IDENTITY, 1.0);
-            (sc.exact).MakePwlInto(&(sc.pts));
+            sc = side->sc1;
             sc.surfA = hs1;
             sc.surfB = hsext;
             hSCurve hc1 = curve.AddAndAssignId(&sc);
@@ -577,12 +732,8 @@ void SShell::MakeFromExtrusionOf(SBezierLoopSet *sbls, Vector t0, Vector t1, Rgb
             (surface.FindById(hsext))->trim.Add(&stb0);
             (surface.FindById(hsext))->trim.Add(&stb1);
 
-            // And form the trim line
-            Vector pt = sb->Finish();
-            sc = {};
-            sc.isExact = true;
-            sc.exact = SBezier::From(pt.Plus(t0), pt.Plus(t1));
-            (sc.exact).MakePwlInto(&(sc.pts));
+            // And the trim line
+            sc = side->line;
             hSCurve hl = curve.AddAndAssignId(&sc);
             // save this for later
             TrimLine tl;
@@ -616,6 +767,14 @@ typedef struct {
     hSSurface   d[4];
 } Revolved;
 
+// The trim curves generated by revolving one curve of the profile, in each
+// quarter turn; and which curve of the profile comes before it in its loop.
+struct RevolvedCurves {
+    SCurve      edge[4];
+    SCurve      circle[4];
+    size_t      prev;
+};
+
 void SShell::MakeFromRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector axis, RgbaColor color, Group *group)
 {
     SBezierLoop *sbl;
@@ -649,11 +808,13 @@ void SShell::MakeFromRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector axis,
         axis = axis.ScaledBy(-1);
     }
 
-    // Now we actually build and trim the surfaces.
+    // Now we actually build the surfaces; those are quick to make, but the
+    // remapping of entities to faces isn't safe to do on several threads.
+    std::vector<SBezier *> sbs;
+    std::vector<Revolved> revolved;
     for(sbl = sbls->l.First(); sbl; sbl = sbls->l.NextAfter(sbl)) {
-        int i, j;
+        int j;
         SBezier *sb;
-        List<Revolved> hsl = {};
 
         for(sb = sbl->l.First(); sb; sb = sbl->l.NextAfter(sb)) {
             Revolved revs;
@@ -681,68 +842,91 @@ void SShell::MakeFromRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector axis,
                     revs.d[j] = surface.AddAndAssignId(&ss);
                 }
             }
-            hsl.Add(&revs);
+            sbs.push_back(sb);
+            revolved.push_back(revs);
         }
+    }
 
+    // Then the trim curves, which are most of the work, and independent for
+    // each input curve; so make those on several threads, and then add them
+    // in order so that they get the same handles regardless.
+    std::vector<RevolvedCurves> curves(sbs.size());
+    size_t k = 0;
+    for(sbl = sbls->l.First(); sbl; sbl = sbls->l.NextAfter(sbl)) {
         for(i = 0; i < sbl->l.n; i++) {
-            Revolved revs  = hsl.elem[i],
-                     revsp = hsl.elem[WRAP(i-1, sbl->l.n)];
+            curves[k + i].prev = k + WRAP(i-1, sbl->l.n);
+        }
+        k += sbl->l.n;
+    }
+    ParallelFor((int)sbs.size(), [&](int m) {
+        Revolved revs  = revolved[m],
+                 revsp = revolved[curves[m].prev];
+        SBezier *sb = sbs[m];
+
+        for(int j = 0; j < 4; j++) {
+            Quaternion qs = Quaternion::From(axis, (PI/2)*j);
+            // we want Q*(x - p) + p = Q*x + (p - Q*p)
+            Vector ts = pt.Minus(qs.Rotate(pt));
+
+            // If this input curve generate a surface, then trim that
+            // surface with the rotated version of the input curve.
+            if(revs.d[j].v) {
+                SCurve *sc = &(curves[m].edge[j]);
+                *sc = {};
+                sc->isExact = true;
+                sc->exact = sb->TransformedBy(ts, qs, 1.0);
+                (sc->exact).MakePwlInto(&(sc->pts));
+                sc->surfA = revs.d[j];
+                sc->surfB = revs.d[WRAP(j-1, 4)];
+            }
 
-            sb   = &(sbl->l.elem[i]);
+            // And if this input curve and the one after it both generated
+            // surfaces, then trim both of those by the appropriate
+            // circle.
+            if(revs.d[j].v && revsp.d[j].v) {
+                SSurface *ss = surface.FindById(revs.d[j]);
+
+                SCurve *sc = &(curves[m].circle[j]);
+                *sc = {};
+                sc->isExact = true;
+                sc->exact = SBezier::From(ss->ctrl[0][0],
+                                          ss->ctrl[0][1],
+                                          ss->ctrl[0][2]);
+                sc->exact.weight[1] = ss->weight[0][1];
+                (sc->exact).MakePwlInto(&(sc->pts));
+                sc->surfA = revs.d[j];
+                sc->surfB = revsp.d[j];
+            }
+        }
+    });
+
+    for(k = 0; k < sbs.size(); k++) {
+        Revolved revs  = revolved[k],
+                 revsp = revolved[curves[k].prev];
+
+        for(int j = 0; j < 4; j++) {
+            if(revs.d[j].v) {
+                SCurve sc = curves[k].edge[j];
+                hSCurve hcb = curve.AddAndAssignId(&sc);
+
+                STrimBy stb;
+                stb = STrimBy::EntireCurve(this, hcb, /*backwards=*/true);
+                (surface.FindById(sc.surfA))->trim.Add(&stb);
+                stb = STrimBy::EntireCurve(this, hcb, /*backwards=*/false);
+                (surface.FindById(sc.surfB))->trim.Add(&stb);
+            }
 
-            for(j = 0; j < 4; j++) {
-                SCurve sc;
-                Quaternion qs = Quaternion::From(axis, (PI/2)*j);
-                // we want Q*(x - p) + p = Q*x + (p - Q*p)
-                Vector ts = pt.Minus(qs.Rotate(pt));
-
-                // If this input curve generate a surface, then trim that
-                // surface with the rotated version of the input curve.
-                if(revs.d[j].v) {
-                    sc = {};
-                    sc.isExact = true;
-                    sc.exact = sb->TransformedBy(ts, qs, 1.0);
-                    (sc.exact).MakePwlInto(&(sc.pts));
-                    sc.surfA = revs.d[j];
-                    sc.surfB = revs.d[WRAP(j-1, 4)];
-
-                    hSCurve hcb = curve.AddAndAssignId(&sc);
-
-                    STrimBy stb;
-                    stb = STrimBy::EntireCurve(this, hcb, /*backwards=*/true);
-                    (surface.FindById(sc.surfA))->trim.Add(&stb);
-                    stb = STrimBy::EntireCurve(this, hcb, /*backwards=*/false);
-                    (surface.FindById(sc.surfB))->trim.Add(&stb);
-                }
+            if(revs.d[j].v && revsp.d[j].v) {
+                SCurve sc = curves[k].circle[j];
+                hSCurve hcc = curve.AddAndAssignId(&sc);
 
-                // And if this input curve and the one after it both generated
-                // surfaces, then trim both of those by the appropriate
-                // circle.
-                if(revs.d[j].v && revsp.d[j].v) {
-                    SSurface *ss = surface.FindById(revs.d[j]);
-
-                    sc = {};
-                    sc.isExact = true;
-                    sc.exact = SBezier::From(ss->ctrl[0][0],
-                                             ss->ctrl[0][1],
-                                             ss->ctrl[0][2]);
-                    sc.exact.weight[1] = ss->weight[0][1];
-                    (sc.exact).MakePwlInto(&(sc.pts));
-                    sc.surfA = revs.d[j];
-                    sc.surfB = revsp.d[j];
-
-                    hSCurve hcc = curve.AddAndAssignId(&sc);
-
-                    STrimBy stb;
-                    stb = STrimBy::EntireCurve(this, hcc, /*backwards=*/false);
-                    (surface.FindById(sc.surfA))->trim.Add(&stb);
-                    stb = STrimBy::EntireCurve(this, hcc, /*backwards=*/true);
-                    (surface.FindById(sc.surfB))->trim.Add(&stb);
-                }
+                STrimBy stb;
+                stb = STrimBy::EntireCurve(this, hcc, /*backwards=*/false);
+                (surface.FindById(sc.surfA))->trim.Add(&stb);
+                stb = STrimBy::EntireCurve(this, hcc, /*backwards=*/true);
+                (surface.FindById(sc.surfB))->trim.Add(&stb);
             }
         }
-
-        hsl.Clear();
     }
 
     for(i = i0; i < surface.n; i++) {
@@ -869,10 +1053,23 @@ void SShell::MakeSectionEdgesInto(Vector n, double d, SEdgeList *sel, SBezierLis
     }
 }
 
+//-----------------------------------------------------------------------------
+// Triangulate all of our surfaces. They're independent of each other, so we
+// do them in parallel, each into its own mesh, and then append those meshes
+// in order so that the result doesn't depend on the threads.
+//-----------------------------------------------------------------------------
 void SShell::TriangulateInto(SMesh *sm) {
-    SSurface *s;
-    for(s = surface.First(); s; s = surface.NextAfter(s)) {
-        s->TriangulateInto(this, sm);
+    std::vector<SMesh> meshes(surface.n);
+    ParallelFor(surface.n, [&](int i) {
+        meshes[i] = {};
+        surface.elem[i].TriangulateInto(this, &meshes[i]);
+    });
+
+    for(SMesh &m : meshes) {
+        for(STriangle &st : m.l) {
+            sm->l.Add(&st);
+        }
+        m.Clear();
     }
 }
 
@@ -892,5 +1089,8 @@ void SShell::Clear() {
         c->Clear();
     }
     curve.Clear();
+
+    surfaceBvh.Clear();
+    edgeBvh.Clear();
 }
 
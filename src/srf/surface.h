@@ -18,6 +18,77 @@ class SBezierList;
 class SSurface;
 class SCurvePt;
 
+// Hash of a key made up of doubles, for the caches that let us skip work
+// on geometry that we've already seen.
+struct DoubleKeyHash {
+    size_t operator()(const std::vector<double> &key) const;
+};
+
+// A bounded cache from such a key to some derived geometry, shared by all
+// the threads. It's split into shards, each with its own lock, so that the
+// workers rarely wait on each other, and a shard whose entries cost more
+// than its share of the limit is just thrown away. Every cache is emptied
+// by ClearAll(), when the sketch is cleared or a file is loaded.
+class GeometryCacheBase {
+public:
+    GeometryCacheBase();
+    virtual ~GeometryCacheBase();
+    virtual void Clear() = 0;
+
+    static void ClearAll();
+};
+
+template<class T>
+class GeometryCache : public GeometryCacheBase {
+public:
+    typedef std::vector<double> Key;
+
+    static const size_t SHARDS = 16;
+    struct Shard {
+        std::mutex                                mutex;
+        std::unordered_map<Key, T, DoubleKeyHash> entry;
+        size_t                                    cost;
+    };
+    Shard   shard[SHARDS];
+    size_t  shardLimit;
+
+    explicit GeometryCache(size_t limit) : shard(), shardLimit(limit / SHARDS) {}
+
+    Shard *ShardFor(const Key &key) {
+        return &shard[DoubleKeyHash()(key) % SHARDS];
+    }
+
+    // Calls fn with the cached value, with the shard locked, if present.
+    template<class F>
+    bool Find(const Key &key, F fn) {
+        Shard *s = ShardFor(key);
+        std::lock_guard<std::mutex> lock(s->mutex);
+        auto it = s->entry.find(key);
+        if(it == s->entry.end()) return false;
+        fn(it->second);
+        return true;
+    }
+
+    void Insert(const Key &key, T value, size_t cost) {
+        Shard *s = ShardFor(key);
+        std::lock_guard<std::mutex> lock(s->mutex);
+        if(s->cost + cost > shardLimit) {
+            s->entry.clear();
+            s->cost = 0;
+        }
+        s->cost += cost;
+        s->entry[key] = std::move(value);
+    }
+
+    void Clear() override {
+        for(Shard &s : shard) {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.entry.clear();
+            s.cost = 0;
+        }
+    }
+};
+
 // Utility data structure, a two-dimensional BSP to accelerate polygon
 // operations.
 class SBspUv {
@@ -37,9 +108,28 @@ public:
         EDGE_OTHER        = 500
     };
 
+    // An edge waiting to be placed in the tree, with the scale factors (as
+    // from ScalePoints) at each of its ends.
+    struct BuildEdge {
+        Point2d a, b;
+        Point2d sa, sb;
+    };
+
+    // How big the trees came out; a point costs one test per level to
+    // classify, so a deep one is worth knowing about.
+    struct Stats {
+        int nodes;
+        int maxDepth;
+    };
+
     static SBspUv *Alloc();
-    static SBspUv *From(SEdgeList *el, SSurface *srf);
+    static SBspUv *From(SEdgeList *el, SSurface *srf, Stats *stats = NULL);
+    static SBspUv *BuildFrom(std::vector<BuildEdge> *edges, SSurface *srf,
+                             bool searchSplitter, int depth, Stats *stats);
 
+    static Point2d ScaleAt(Point2d pt, SSurface *srf);
+    static double ScaledSignedDistanceToLine(Point2d pt, Point2d a, Point2d b,
+        Point2d scale);
     void ScalePoints(Point2d *pt, Point2d *a, Point2d *b, SSurface *srf) const;
     double ScaledSignedDistanceToLine(Point2d pt, Point2d a, Point2d b,
         SSurface *srf) const;
@@ -49,8 +139,11 @@ public:
     void InsertEdge(Point2d a, Point2d b, SSurface *srf);
     static SBspUv *InsertOrCreateEdge(SBspUv *where, Point2d ea, Point2d eb, SSurface *srf);
     Class ClassifyPoint(Point2d p, Point2d eb, SSurface *srf) const;
+    Class ClassifyPointScaled(Point2d p, Point2d eb, SSurface *srf,
+                              Point2d scale) const;
     Class ClassifyEdge(Point2d ea, Point2d eb, SSurface *srf) const;
     double MinimumDistanceToEdge(Point2d p, SSurface *srf) const;
+    double MinimumDistanceToEdgeScaled(Point2d p, Point2d scale) const;
 };
 
 // Now the data structures to represent a shell of trimmed rational polynomial
@@ -94,8 +187,11 @@ public:
     void MakePwlInto(List<SCurvePt> *l, double chordTol=0) const;
     void MakePwlInto(SContour *sc, double chordTol=0) const;
     void MakePwlInto(List<Vector> *l, double chordTol=0) const;
-    void MakePwlWorker(List<Vector> *l, double ta, double tb, double chordTol) const;
-    void MakePwlInitialWorker(List<Vector> *l, double ta, double tb, double chordTol) const;
+    void MakePwlUncachedInto(List<Vector> *l, double chordTol) const;
+    void MakePwlWorker(List<Vector> *l, double ta, double tb,
+                       Vector pa, Vector pb, double chordTol) const;
+    void MakePwlInitialWorker(List<Vector> *l, double ta, double tb,
+                              Vector pa, Vector pb, double chordTol) const;
     void MakeNonrationalCubicInto(SBezierList *bl, double tolerance, int depth = 0) const;
 
     void AllIntersectionsWith(const SBezier *sbb, SPointList *spl) const;
@@ -277,10 +373,6 @@ public:
     SBspUv          *bsp;
     SEdgeList       edges;
 
-    // For caching our initial (u, v) when doing Newton iterations to project
-    // a point into our surface.
-    Point2d         cached;
-
     static SSurface FromExtrusionOf(SBezier *spc, Vector t0, Vector t1);
     static SSurface FromRevolutionOf(SBezier *sb, Vector pt, Vector axis,
                                         double thetas, double thetaf);
@@ -300,9 +392,10 @@ public:
                                     SShell *into, SSurface::CombineAs type);
     void TrimFromEdgeList(SEdgeList *el, bool asUv);
     void IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
-                          SShell *into);
+                          SShell *into, SShell *copied);
     void AddExactIntersectionCurve(SBezier *sb, SSurface *srfB,
-                          SShell *agnstA, SShell *agnstB, SShell *into);
+                          SShell *agnstA, SShell *agnstB, SShell *into,
+                          SShell *copied);
 
     typedef struct {
         int     tag;
@@ -329,21 +422,28 @@ public:
 
     bool PointIntersectingLine(Vector p0, Vector p1, double *u, double *v) const;
     Vector ClosestPointOnThisAndSurface(SSurface *srf2, Vector p);
+    bool ClosestPointOnThisAndSurface(SSurface *srf2, Vector p,
+                                      Point2d *puv, Point2d *puv2, Vector *pc);
     void PointOnSurfaces(SSurface *s1, SSurface *s2, double *u, double *v);
     Vector PointAt(double u, double v) const;
     Vector PointAt(Point2d puv) const;
     void TangentsAt(double u, double v, Vector *tu, Vector *tv) const;
     Vector NormalAt(Point2d puv) const;
     Vector NormalAt(double u, double v) const;
+    void PointsAt(const Point2d *puv, int n, Vector *pts) const;
+    void NormalsAt(const Point2d *puv, int n, Vector *normals) const;
     bool LineEntirelyOutsideBbox(Vector a, Vector b, bool asSegment) const;
     void GetAxisAlignedBounding(Vector *ptMax, Vector *ptMin) const;
     bool CoincidentWithPlane(Vector n, double d) const;
     bool CoincidentWith(SSurface *ss, bool sameNormal) const;
     bool IsExtrusion(SBezier *of, Vector *along) const;
+    bool IsExtrusionAlongU(SSurface *swapped) const;
     bool IsCylinder(Vector *axis, Vector *center, double *r,
                         Vector *start, Vector *finish) const;
 
     void TriangulateInto(SShell *shell, SMesh *sm);
+    void TriangulateUncachedInto(SShell *shell, SMesh *sm);
+    void MakeTriangulationKey(SShell *shell, std::vector<double> *key);
 
     // these are intended as bitmasks, even though there's just one now
     enum class MakeAs : uint32_t {
@@ -367,6 +467,46 @@ public:
     void Clear();
 };
 
+// Utility data structure, a bounding volume hierarchy over the axis-aligned
+// bounding boxes of a shell's surfaces (or of their trim edges), so that we
+// don't need to test every surface against every other one, or every ray
+// against every surface.
+class SSurfaceBvh {
+public:
+    class Item {
+    public:
+        Vector      max, min;
+        int         index;      // of the surface within the shell
+        int         edge;       // within the surface's edges, or -1
+        SSurface   *srf;
+    };
+    class Node {
+    public:
+        Vector      max, min;
+        int         child[2];   // or -1 if this is a leaf
+        int         first, count;
+    };
+
+    static const int LEAF_SIZE = 4;
+
+    std::vector<Item>   item;
+    std::vector<Node>   node;
+
+    void Build(SShell *shell);
+    void BuildFromEdges(SShell *shell);
+    int BuildRange(int first, int count);
+    void OverlappingPairsWith(const SSurfaceBvh *b,
+                              std::vector<std::pair<int, int>> *pairs) const;
+    void OverlappingPairsBelow(int na, const SSurfaceBvh *b, int nb,
+                               std::vector<std::pair<int, int>> *pairs) const;
+    void ItemsNearLine(Vector a, Vector b, bool asSegment,
+                       std::vector<const Item *> *found) const;
+    void ItemsNearBox(Vector max, Vector min,
+                      std::vector<const Item *> *found) const;
+    bool IsEmpty() const { return node.empty(); }
+    void Clear();
+};
+
 class SShell {
 public:
     IdList<SCurve,hSCurve>      curve;
@@ -374,6 +514,11 @@ public:
 
     bool                        booleanFailed;
 
+    // Built along with the classifying BSPs during a Boolean, to find the
+    // surfaces and trim edges near a ray quickly; empty otherwise.
+    SSurfaceBvh                 surfaceBvh;
+    SSurfaceBvh                 edgeBvh;
+
     void MakeFromExtrusionOf(SBezierLoopSet *sbls, Vector t0, Vector t1,
                              RgbaColor color);
     void MakeFromRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector axis,
@@ -385,9 +530,14 @@ public:
     void CopyCurvesSplitAgainst(bool opA, SShell *agnst, SShell *into);
     void CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type);
     void MakeIntersectionCurvesAgainst(SShell *against, SShell *into);
+    void AddIntersectionCurve(SCurve *sc, SShell *agnstA, SShell *agnstB);
     void MakeClassifyingBsps(SShell *useCurvesFrom);
     void AllPointsIntersecting(Vector a, Vector b, List<SInter> *il,
                                 bool asSegment, bool trimmed, bool inclTangent);
+    void SurfacesNearLine(Vector a, Vector b, bool asSegment,
+                          std::vector<SSurface *> *srfs);
+    void SurfacesNearBox(Vector bmax, Vector bmin,
+                         std::vector<SSurface *> *srfs);
     void MakeCoincidentEdgesInto(SSurface *proto, bool sameNormal,
                                  SEdgeList *el, SShell *useCurvesFrom);
     void RewriteSurfaceHandlesForCurves(SShell *a, SShell *b);
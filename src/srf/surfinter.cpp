@@ -9,8 +9,22 @@
 
 extern int FLAG;
 
+//-----------------------------------------------------------------------------
+// Is there an exact curve in sh that's identical to sb, in either direction?
+//-----------------------------------------------------------------------------
+static bool HasIdenticalExactCurve(SShell *sh, SBezier *sb) {
+    SBezier sbrev = *sb;
+    sbrev.Reverse();
+    for(SCurve &se : sh->curve) {
+        if(!se.isExact) continue;
+        if(sb->Equals(&(se.exact)) || sbrev.Equals(&(se.exact))) return true;
+    }
+    return false;
+}
+
 void SSurface::AddExactIntersectionCurve(SBezier *sb, SSurface *srfB,
-                                         SShell *agnstA, SShell *agnstB, SShell *into)
+                                         SShell *agnstA, SShell *agnstB, SShell *into,
+                                         SShell *copied)
 {
     SCurve sc = {};
     // Important to keep the order of (surfA, surfB) consistent; when we later
@@ -20,92 +34,170 @@ void SSurface::AddExactIntersectionCurve(SBezier *sb, SSurface *srfB,
     sc.exact = *sb;
     sc.isExact = true;
 
-    // Now we have to piecewise linearize the curve. If there's already an
-    // identical curve in the shell, then follow that pwl exactly, otherwise
-    // calculate from scratch.
-    SCurve split, *existing = NULL, *se;
-    SBezier sbrev = *sb;
-    sbrev.Reverse();
-    bool backwards = false;
-    for(se = into->curve.First(); se; se = into->curve.NextAfter(se)) {
-        if(se->isExact) {
-            if(sb->Equals(&(se->exact))) {
-                existing = se;
-                break;
-            }
-            if(sbrev.Equals(&(se->exact))) {
-                existing = se;
-                backwards = true;
-                break;
+    ssassert(!(sb->Start()).Equals(sb->Finish()),
+             "Unexpected zero-length edge");
+
+    // If an identical curve was copied from one of the shells, then
+    // SShell::AddIntersectionCurve will make us follow its pwl, so there's
+    // no point making our own. An identical curve from another pair of
+    // surfaces does the same, but that pair may be getting intersected on
+    // another thread right now, so for those we just do the work twice.
+    if(HasIdenticalExactCurve(copied, sb)) {
+        sc.source = SCurve::Source::INTERSECTION;
+        into->curve.AddAndAssignId(&sc);
+        return;
+    }
+
+    // Otherwise, we have to piecewise linearize the curve, and split the
+    // line where it intersects our existing surfaces.
+    sb->MakePwlInto(&(sc.pts));
+    SCurve split = sc.MakeCopySplitAgainst(agnstA, agnstB, this, srfB);
+    sc.Clear();
+
+    split.source = SCurve::Source::INTERSECTION;
+    into->curve.AddAndAssignId(&split);
+}
+
+//-----------------------------------------------------------------------------
+// Add a curve from intersecting a surface of agnstA with a surface of agnstB,
+// taking ownership of its points. If the curve is exact and there's already
+// an identical curve in the shell, then follow that pwl exactly; and discard
+// exact curves that lie entirely outside one of the two surfaces.
+//-----------------------------------------------------------------------------
+void SShell::AddIntersectionCurve(SCurve *sc, SShell *agnstA, SShell *agnstB) {
+    if(sc->isExact) {
+        SCurve *existing = NULL, *se;
+        SBezier sbrev = sc->exact;
+        sbrev.Reverse();
+        bool backwards = false;
+        for(se = curve.First(); se; se = curve.NextAfter(se)) {
+            if(se->isExact) {
+                if(sc->exact.Equals(&(se->exact))) {
+                    existing = se;
+                    break;
+                }
+                if(sbrev.Equals(&(se->exact))) {
+                    existing = se;
+                    backwards = true;
+                    break;
+                }
             }
         }
-    }
-    if(existing) {
-        SCurvePt *v;
-        for(v = existing->pts.First(); v; v = existing->pts.NextAfter(v)) {
-            sc.pts.Add(v);
+        if(existing) {
+            sc->pts.Clear();
+            SCurvePt *v;
+            for(v = existing->pts.First(); v; v = existing->pts.NextAfter(v)) {
+                sc->pts.Add(v);
+            }
+            if(backwards) sc->pts.Reverse();
         }
-        if(backwards) sc.pts.Reverse();
-        split = sc;
-        sc = {};
-    } else {
-        sb->MakePwlInto(&(sc.pts));
-        // and split the line where it intersects our existing surfaces
-        split = sc.MakeCopySplitAgainst(agnstA, agnstB, this, srfB);
-        sc.Clear();
-    }
 
-    // Test if the curve lies entirely outside one of the
-    SCurvePt *scpt;
-    bool withinA = false, withinB = false;
-    for(scpt = split.pts.First(); scpt; scpt = split.pts.NextAfter(scpt)) {
-        double tol = 0.01;
-        Point2d puv;
-        ClosestPointTo(scpt->p, &puv);
-        if(puv.x > -tol && puv.x < 1 + tol &&
-           puv.y > -tol && puv.y < 1 + tol)
-        {
-            withinA = true;
+        // Test if the curve lies entirely outside one of the
+        SSurface *srfA = sc->GetSurfaceA(agnstA, agnstB),
+                 *srfB = sc->GetSurfaceB(agnstA, agnstB);
+        SCurvePt *scpt;
+        bool withinA = false, withinB = false;
+        for(scpt = sc->pts.First(); scpt; scpt = sc->pts.NextAfter(scpt)) {
+            double tol = 0.01;
+            Point2d puv;
+            srfA->ClosestPointTo(scpt->p, &puv);
+            if(puv.x > -tol && puv.x < 1 + tol &&
+               puv.y > -tol && puv.y < 1 + tol)
+            {
+                withinA = true;
+            }
+            srfB->ClosestPointTo(scpt->p, &puv);
+            if(puv.x > -tol && puv.x < 1 + tol &&
+               puv.y > -tol && puv.y < 1 + tol)
+            {
+                withinB = true;
+            }
+            // Break out early, no sense wasting time if we already have the answer.
+            if(withinA && withinB) break;
         }
-        srfB->ClosestPointTo(scpt->p, &puv);
-        if(puv.x > -tol && puv.x < 1 + tol &&
-           puv.y > -tol && puv.y < 1 + tol)
-        {
-            withinB = true;
+        if(!(withinA && withinB)) {
+            // Intersection curve lies entirely outside one of the surfaces, so
+            // it's fake.
+            sc->Clear();
+            return;
         }
-        // Break out early, no sense wasting time if we already have the answer.
-        if(withinA && withinB) break;
-    }
-    if(!(withinA && withinB)) {
-        // Intersection curve lies entirely outside one of the surfaces, so
-        // it's fake.
-        split.Clear();
-        return;
     }
 
-#if 0
-    if(sb->deg == 2) {
-        dbp(" ");
-        SCurvePt *prev = NULL, *v;
-        dbp("split.pts.n = %d", split.pts.n);
-        for(v = split.pts.First(); v; v = split.pts.NextAfter(v)) {
-            if(prev) {
-                Vector e = (prev->p).Minus(v->p).WithMagnitude(0);
-                SS.nakedEdges.AddEdge((prev->p).Plus(e), (v->p).Minus(e));
+    curve.AddAndAssignId(sc);
+}
+
+//-----------------------------------------------------------------------------
+// Find the pieces of the conic sb that lie within all of the half-spaces
+// n[k].p >= d[k]. Along a rational quadratic the signed distance to a plane
+// has the sign of a quadratic in t, so we split at the roots of those within
+// (0, 1), and keep the pieces whose midpoints are inside everything.
+//-----------------------------------------------------------------------------
+static void ClipConicTo(const SBezier *sb, int hn, const Vector *n, const double *d,
+                        SBezierList *pieces)
+{
+    std::vector<double> ts = { 0, 1 };
+    for(int k = 0; k < hn; k++) {
+        // The numerator of the distance, in the Bernstein basis and then as
+        // qa*t^2 + qb*t + qc.
+        double b[3];
+        for(int i = 0; i < 3; i++) {
+            b[i] = sb->weight[i]*(n[k].Dot(sb->ctrl[i]) - d[k]);
+        }
+        double qa = b[0] - 2*b[1] + b[2],
+               qb = 2*(b[1] - b[0]),
+               qc = b[0];
+
+        double roots[2];
+        int nr = 0;
+        if(fabs(qa) < LENGTH_EPS) {
+            if(fabs(qb) > LENGTH_EPS) roots[nr++] = -qc/qb;
+        } else {
+            double disc = qb*qb - 4*qa*qc;
+            if(disc >= 0) {
+                roots[nr++] = (-qb + sqrt(disc))/(2*qa);
+                roots[nr++] = (-qb - sqrt(disc))/(2*qa);
             }
-            prev = v;
+        }
+        for(int i = 0; i < nr; i++) {
+            if(roots[i] > 0 && roots[i] < 1) ts.push_back(roots[i]);
         }
     }
-#endif // 0
-    ssassert(!(sb->Start()).Equals(sb->Finish()),
-             "Unexpected zero-length edge");
+    std::sort(ts.begin(), ts.end());
 
-    split.source = SCurve::Source::INTERSECTION;
-    into->curve.AddAndAssignId(&split);
+    auto addPiece = [&](double t0, double t1) {
+        SBezier piece = *sb, bef, aft;
+        if(t1 < 1) {
+            piece.SplitAt(t1, &bef, &aft);
+            piece = bef;
+        }
+        if(t0 > 0) {
+            piece.SplitAt(t0/t1, &bef, &aft);
+            piece = aft;
+        }
+        if((piece.Start()).Equals(piece.Finish())) return;
+        pieces->l.Add(&piece);
+    };
+
+    bool inside = false;
+    double from = 0;
+    for(size_t i = 0; i + 1 < ts.size(); i++) {
+        double ta = ts[i], tb = ts[i+1];
+        if(tb - ta < LENGTH_EPS) continue;
+
+        Vector pm = sb->PointAt((ta + tb)/2);
+        bool within = true;
+        for(int k = 0; k < hn; k++) {
+            if(n[k].Dot(pm) - d[k] < -LENGTH_EPS) within = false;
+        }
+        if(within && !inside) from = ta;
+        if(!within && inside) addPiece(from, ta);
+        inside = within;
+    }
+    if(inside) addPiece(from, 1);
 }
 
 void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
-                                SShell *into)
+                                SShell *into, SShell *copied)
 {
     Vector amax, amin, bmax, bmin;
     GetAxisAlignedBounding(&amax, &amin);
@@ -116,10 +208,39 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
         return;
     }
 
+    // For the special cases below, we work with the geometry of et and eb;
+    // those are this and b, unless we had to swap u and v to see that one is
+    // a surface of extrusion. The curves go into the shell against this and
+    // b either way, since they lie on the same surfaces.
+    SSurface swappedt, swappedb;
+    SSurface *et = this, *eb = b;
+    if(!IsExtrusion(NULL, NULL) && IsExtrusionAlongU(&swappedt)) {
+        et = &swappedt;
+    }
+    if(!b->IsExtrusion(NULL, NULL) && b->IsExtrusionAlongU(&swappedb)) {
+        eb = &swappedb;
+    }
+
     Vector alongt, alongb;
     SBezier oft, ofb;
-    bool isExtdt = this->IsExtrusion(&oft, &alongt),
-         isExtdb =    b->IsExtrusion(&ofb, &alongb);
+    bool isExtdt = et->IsExtrusion(&oft, &alongt),
+         isExtdb = eb->IsExtrusion(&ofb, &alongb);
+
+    Vector axist, axisb, centert, centerb, startt, startb, finisht, finishb;
+    double rt, rb;
+    bool isCylt = et->IsCylinder(&axist, &centert, &rt, &startt, &finisht),
+         isCylb = eb->IsCylinder(&axisb, &centerb, &rb, &startb, &finishb);
+    bool axesMeet = false;
+    Vector axesMeetAt;
+    if(isCylt && isCylb) {
+        bool skew;
+        axesMeetAt = Vector::AtIntersectionOfLines(centert, centert.Plus(axist),
+                                                   centerb, centerb.Plus(axisb),
+                                                   &skew, NULL, NULL);
+        axesMeet = !skew &&
+                   (axist.Cross(axisb)).Magnitude() >
+                        LENGTH_EPS*axist.Magnitude()*axisb.Magnitude();
+    }
 
     if(degm == 1 && degn == 1 && b->degm == 1 && b->degn == 1) {
         // Line-line intersection; it's a plane or nothing.
@@ -179,7 +300,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
         if(tmax > tmin + LENGTH_EPS) {
             SBezier bezier = SBezier::From(p.Plus(dl.ScaledBy(tmin)),
                                            p.Plus(dl.ScaledBy(tmax)));
-            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into);
+            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into, copied);
         }
     } else if((degm == 1 && degn == 1 && isExtdb) ||
               (b->degm == 1 && b->degn == 1 && isExtdt))
@@ -188,10 +309,10 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
         SSurface *splane, *sext;
         if(degm == 1 && degn == 1) {
             splane = this;
-            sext = b;
+            sext = eb;
         } else {
             splane = b;
-            sext = this;
+            sext = et;
         }
 
         Vector n = splane->NormalAt(0, 0).WithMagnitude(1), along;
@@ -224,7 +345,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
                 Vector al = along.ScaledBy(0.5);
                 SBezier bezier;
                 bezier = SBezier::From((si->p).Minus(al), (si->p).Plus(al));
-                AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into);
+                AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into, copied);
             }
 
             inters.Clear();
@@ -240,7 +361,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
                     Vector::AtIntersectionOfPlaneAndLine(n, d, p0, p1, NULL);
             }
 
-            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into);
+            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into, copied);
         }
     } else if(isExtdt && isExtdb &&
                 sqrt(fabs(alongt.Dot(alongb))) >
@@ -253,10 +374,10 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
         List<SInter> inters = {};
         List<Vector> lv = {};
 
-        double a_axis0 = (   ctrl[0][0]).Dot(axis),
-               a_axis1 = (   ctrl[0][1]).Dot(axis),
-               b_axis0 = (b->ctrl[0][0]).Dot(axis),
-               b_axis1 = (b->ctrl[0][1]).Dot(axis);
+        double a_axis0 = (et->ctrl[0][0]).Dot(axis),
+               a_axis1 = (et->ctrl[0][1]).Dot(axis),
+               b_axis0 = (eb->ctrl[0][0]).Dot(axis),
+               b_axis1 = (eb->ctrl[0][1]).Dot(axis);
 
         if(a_axis0 > a_axis1) swap(a_axis0, a_axis1);
         if(b_axis0 > b_axis1) swap(b_axis0, b_axis1);
@@ -283,7 +404,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
             pa = pa.Plus(axisc);
             pb = pb.Plus(axisc);
 
-            b->AllPointsIntersecting(pa, pb, &inters,
+            eb->AllPointsIntersecting(pa, pb, &inters,
                 /*asSegment=*/true,/*trimmed=*/false, /*inclTangent=*/false);
         }
 
@@ -291,21 +412,71 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
         for(si = inters.First(); si; si = inters.NextAfter(si)) {
             Vector p = (si->p).Minus(axis.ScaledBy((si->p).Dot(axis)));
             double ub, vb;
-            b->ClosestPointTo(p, &ub, &vb, /*mustConverge=*/true);
+            eb->ClosestPointTo(p, &ub, &vb, /*mustConverge=*/true);
             SSurface plane;
             plane = SSurface::FromPlane(p, axis.Normal(0), axis.Normal(1));
 
-            b->PointOnSurfaces(this, &plane, &ub, &vb);
+            eb->PointOnSurfaces(et, &plane, &ub, &vb);
 
-            p = b->PointAt(ub, vb);
+            p = eb->PointAt(ub, vb);
 
             SBezier bezier;
             bezier = SBezier::From(p.Plus(axis0), p.Plus(axis1));
-            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into);
+            AddExactIntersectionCurve(&bezier, b, agnstA, agnstB, into, copied);
         }
 
         inters.Clear();
         lv.Clear();
+    } else if(axesMeet && fabs(rt - rb) < LENGTH_EPS) {
+        // Two cylinders of the same radius, whose axes meet (like a tee or
+        // a mitred elbow in a pipe). They intersect in two ellipses, in the
+        // planes through the point where the axes meet that bisect the
+        // angles between the axes. So each ellipse is exactly our circle,
+        // projected along our axis into that plane. That lies on our side
+        // of the cylinder, but it may run off either end of us, and off any
+        // edge of b; so we keep only the pieces within the planes that bound
+        // the two patches.
+        Vector at = alongt.WithMagnitude(1),
+               ab = alongb.WithMagnitude(1);
+        Vector hn[6];
+        double hd[6];
+        // between the ends of each
+        hn[0] = at;              hd[0] = at.Dot(startt);
+        hn[1] = at.ScaledBy(-1); hd[1] = -at.Dot(startt.Plus(alongt));
+        hn[2] = ab;              hd[2] = ab.Dot(startb);
+        hn[3] = ab.ScaledBy(-1); hd[3] = -ab.Dot(startb.Plus(alongb));
+        // and within the wedge that b's arc sweeps out about its axis
+        Vector sb = startb.Minus(centerb), fb = finishb.Minus(centerb);
+        hn[4] = (ab.Cross(sb)).WithMagnitude(1);
+        if(hn[4].Dot(fb) < 0) hn[4] = hn[4].ScaledBy(-1);
+        hn[5] = (ab.Cross(fb)).WithMagnitude(1);
+        if(hn[5].Dot(sb) < 0) hn[5] = hn[5].ScaledBy(-1);
+        hd[4] = hn[4].Dot(centerb);
+        hd[5] = hn[5].Dot(centerb);
+
+        int i, j;
+        for(i = 0; i < 2; i++) {
+            Vector n = (i == 0) ? at.Plus(ab) : at.Minus(ab);
+            n = n.WithMagnitude(1);
+            double d = n.Dot(axesMeetAt);
+
+            SBezier bezier = oft;
+            for(j = 0; j <= bezier.deg; j++) {
+                Vector p0 = bezier.ctrl[j],
+                       p1 = p0.Plus(alongt);
+
+                bezier.ctrl[j] =
+                    Vector::AtIntersectionOfPlaneAndLine(n, d, p0, p1, NULL);
+            }
+            if((bezier.Start()).Equals(bezier.Finish())) continue;
+
+            SBezierList pieces = {};
+            ClipConicTo(&bezier, 6, hn, hd, &pieces);
+            for(SBezier &piece : pieces.l) {
+                AddExactIntersectionCurve(&piece, b, agnstA, agnstB, into, copied);
+            }
+            pieces.Clear();
+        }
     } else {
         // Try intersecting the surfaces numerically, by a marching algorithm.
         // First, we find all the intersections between a surface and the
@@ -384,18 +555,36 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
             padd.p = start;
             sc.pts.Add(&padd);
 
+            // We march along the curve by stepping along its tangent, and then
+            // pulling that point back onto both surfaces. The distance that
+            // we pull it is about k*step^2/2, for curvature k; so from each
+            // try we can predict the step that would hit our target. That
+            // deviation from the tangent is four times the sag of the chord
+            // that we're adding, so even the top of our band leaves us at
+            // half the chord tolerance.
+            double tollo = maxtol, tolhi = 2*maxtol, toltarget = 1.5*maxtol;
+            // And where the curve is straight, there's nothing to predict
+            // from, so don't step further than across either surface.
+            double maxstep = min((amax.Minus(amin)).Magnitude(),
+                                 (bmax.Minus(bmin)).Magnitude());
+            maxstep = max(maxstep, maxtol);
+
             Point2d pa, pb;
+            ClosestPointTo(start, &pa);
+            b->ClosestPointTo(start, &pb);
+
             Vector np, npc = Vector::From(0, 0, 0);
             bool fwd = false;
             // Better to start with a too-small step, so that we don't miss
             // features of the curve entirely.
             double tol, step = maxtol;
             for(a = 0; a < maxsteps; a++) {
-                ClosestPointTo(start, &pa);
-                b->ClosestPointTo(start, &pb);
+                Vector tua, tva, tub, tvb;
+                   TangentsAt(pa.x, pa.y, &tua, &tva);
+                b->TangentsAt(pb.x, pb.y, &tub, &tvb);
 
-                Vector na =    NormalAt(pa).WithMagnitude(1),
-                       nb = b->NormalAt(pb).WithMagnitude(1);
+                Vector na = (tua.Cross(tva)).WithMagnitude(1),
+                       nb = (tub.Cross(tvb)).WithMagnitude(1);
 
                 if(a == 0) {
                     Vector dp = nb.Cross(na);
@@ -407,6 +596,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
                     }
                 }
 
+                Point2d npa, npb;
                 int i;
                 for(i = 0; i < 20; i++) {
                     Vector dp = nb.Cross(na);
@@ -414,21 +604,38 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
                     dp = dp.WithMagnitude(step);
 
                     np = start.Plus(dp);
-                    npc = ClosestPointOnThisAndSurface(b, np);
-                    tol = (npc.Minus(np)).Magnitude();
 
-                    if(tol > maxtol*0.8) {
-                        step *= 0.90;
-                    } else {
-                        step /= 0.90;
+                    // Predict where that lands in both surfaces, to start our
+                    // Newton iterations close; and if they diverge from there,
+                    // then start over from scratch.
+                    npa = pa.Plus(Point2d::From(dp.Dot(tua)/tua.MagSquared(),
+                                                dp.Dot(tva)/tva.MagSquared()));
+                    npb = pb.Plus(Point2d::From(dp.Dot(tub)/tub.MagSquared(),
+                                                dp.Dot(tvb)/tvb.MagSquared()));
+                    if(!ClosestPointOnThisAndSurface(b, np, &npa, &npb, &npc)) {
+                        npc = ClosestPointOnThisAndSurface(b, np);
+                        ClosestPointTo(npc, &npa);
+                        b->ClosestPointTo(npc, &npb);
                     }
+                    tol = (npc.Minus(np)).Magnitude();
+
+                    // Scale the step by whatever would have hit our target,
+                    // but not by too much in one go, since that's only an
+                    // estimate of the curvature.
+                    double scale = (tol > 0) ? sqrt(toltarget/tol) : 4;
+                    scale = max(0.25, min(4.0, scale));
+                    bool longest = (step >= maxstep);
+                    step = min(maxstep, step*scale);
 
-                    if((tol < maxtol) && (tol > maxtol/2)) {
+                    if((tol < tolhi) && (tol > tollo || longest)) {
                         // If we meet the chord tolerance test, and we're
-                        // not too fine, then we break out.
+                        // not too fine, then we break out, with our next
+                        // step already scaled to suit.
                         break;
                     }
                 }
+                pa = npa;
+                pb = npb;
 
                 SPoint *sp;
                 for(sp = spl.l.First(); sp; sp = spl.l.NextAfter(sp)) {
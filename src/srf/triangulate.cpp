@@ -65,6 +65,21 @@ void SPolygon::UvTriangulateInto(SMesh *m, SSurface *srf) {
         }
 
 //        dbp("finished finding holes: %d ms", (int)(GetMilliseconds() - in));
+        // Bin those edges, so that each bridge we try needn't be tested
+        // against all of them.
+        SEdgeGrid eg = {};
+        Vector emax = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, VERY_NEGATIVE),
+               emin = Vector::From(VERY_POSITIVE, VERY_POSITIVE, VERY_POSITIVE);
+        SEdge *se;
+        for(se = el.l.First(); se; se = el.l.NextAfter(se)) {
+            (se->a).MakeMaxMin(&emax, &emin);
+            (se->b).MakeMaxMin(&emax, &emin);
+        }
+        eg.Init(emax, emin, el.l.n);
+        for(se = el.l.First(); se; se = el.l.NextAfter(se)) {
+            eg.AddEdge(se->a, se->b);
+        }
+
         for(;;) {
             double xmin = 1e10;
             SContour *scmin = NULL;
@@ -79,7 +94,7 @@ void SPolygon::UvTriangulateInto(SMesh *m, SSurface *srf) {
             }
             if(!scmin) break;
 
-            if(!merged.BridgeToContour(scmin, &el, &vl)) {
+            if(!merged.BridgeToContour(scmin, &eg, &vl)) {
                 dbp("couldn't merge our hole");
                 return;
             }
@@ -106,7 +121,7 @@ void SPolygon::UvTriangulateInto(SMesh *m, SSurface *srf) {
 }
 
 bool SContour::BridgeToContour(SContour *sc,
-                               SEdgeList *avoidEdges, List<Vector> *avoidPts)
+                               SEdgeGrid *avoidEdges, List<Vector> *avoidPts)
 {
     int i, j;
 
@@ -176,7 +191,7 @@ bool SContour::BridgeToContour(SContour *sc,
             }
             if(f) continue;
 
-            if(avoidEdges->AnyEdgeCrossings(a, b) > 0) {
+            if(avoidEdges->AnyEdgeCrosses(a, b)) {
                 // doesn't work, bridge crosses an existing edge
             } else {
                 goto haveEdge;
@@ -213,10 +228,13 @@ haveEdge:
     return true;
 }
 
-bool SContour::IsEar(int bp, double scaledEps) const {
-    int ap = WRAP(bp-1, l.n),
-        cp = WRAP(bp+1, l.n);
-
+//-----------------------------------------------------------------------------
+// Is the vertex bp, between ap and cp (its neighbours among the vertices not
+// yet clipped), an ear?
+//-----------------------------------------------------------------------------
+bool SContour::IsEar(int ap, int bp, int cp, double scaledEps,
+                     const SEdgeGrid *pts) const
+{
     STriangle tr = {};
     tr.a = l.elem[ap].p;
     tr.b = l.elem[bp].p;
@@ -235,36 +253,35 @@ bool SContour::IsEar(int bp, double scaledEps) const {
         return false;
     }
 
-    // Accelerate with an axis-aligned bounding box test
+    // Accelerate with an axis-aligned bounding box test, and look only at
+    // the points binned near that box.
     Vector maxv = tr.a, minv = tr.a;
     (tr.b).MakeMaxMin(&maxv, &minv);
     (tr.c).MakeMaxMin(&maxv, &minv);
 
-    int i;
-    for(i = 0; i < l.n; i++) {
-        if(i == ap || i == bp || i == cp) continue;
-
-        Vector p = l.elem[i].p;
-        if(p.OutsideAndNotOn(maxv, minv)) continue;
+    bool inside = pts->AnyNear(maxv, minv, [&](const SEdge &se) {
+        Vector p = se.a;
+        if(p.OutsideAndNotOn(maxv, minv)) return false;
 
         // A point on the edge of the triangle is considered to be inside,
         // and therefore makes it a non-ear; but a point on the vertex is
-        // "outside", since that's necessary to make bridges work.
-        if(p.EqualsExactly(tr.a)) continue;
-        if(p.EqualsExactly(tr.b)) continue;
-        if(p.EqualsExactly(tr.c)) continue;
-
-        if(tr.ContainsPointProjd(n, p)) {
-            return false;
-        }
-    }
-    return true;
+        // "outside", since that's necessary to make bridges work, and for
+        // contours that touch themselves at a vertex. Those points were
+        // joined within our epsilon when the trim was assembled, so they
+        // may not be exactly equal. This also skips the points of the
+        // triangle itself.
+        if(p.Equals(tr.a, scaledEps)) return false;
+        if(p.Equals(tr.b, scaledEps)) return false;
+        if(p.Equals(tr.c, scaledEps)) return false;
+
+        return tr.ContainsPointProjd(n, p);
+    });
+    return !inside;
 }
 
-void SContour::ClipEarInto(SMesh *m, int bp, double scaledEps) {
-    int ap = WRAP(bp-1, l.n),
-        cp = WRAP(bp+1, l.n);
-
+void SContour::ClipEarInto(SMesh *m, int ap, int bp, int cp,
+                           double scaledEps) const
+{
     STriangle tr = {};
     tr.a = l.elem[ap].p;
     tr.b = l.elem[bp].p;
@@ -275,15 +292,6 @@ void SContour::ClipEarInto(SMesh *m, int bp, double scaledEps) {
     } else {
         m->AddTriangle(&tr);
     }
-
-    // By deleting the point at bp, we may change the ear-ness of the points
-    // on either side.
-    l.elem[ap].ear = EarType::UNKNOWN;
-    l.elem[cp].ear = EarType::UNKNOWN;
-
-    l.ClearTags();
-    l.elem[bp].tag = 1;
-    l.RemoveTagged();
 }
 
 void SContour::UvTriangulateInto(SMesh *m, SSurface *srf) {
@@ -305,58 +313,112 @@ void SContour::UvTriangulateInto(SMesh *m, SSurface *srf) {
     }
     l.RemoveTagged();
 
-    // Now calculate the ear-ness of each vertex
+    // Bin the vertices, so that testing for an ear looks only at the ones
+    // nearby.
+    SEdgeGrid pts = {};
+    Vector pmax = Vector::From(VERY_NEGATIVE, VERY_NEGATIVE, VERY_NEGATIVE),
+           pmin = Vector::From(VERY_POSITIVE, VERY_POSITIVE, VERY_POSITIVE);
+    for(i = 0; i < l.n; i++) {
+        (l.elem[i].p).MakeMaxMin(&pmax, &pmin);
+    }
+    pts.Init(pmax, pmin, l.n);
     for(i = 0; i < l.n; i++) {
-        (l.elem[i]).ear = IsEar(i, scaledEps) ? EarType::EAR : EarType::NOT_EAR;
+        pts.AddPoint(l.elem[i].p);
     }
 
-    bool toggle = false;
-    while(l.n > 3) {
-        // Some points may have changed ear-ness, so recalculate
-        for(i = 0; i < l.n; i++) {
-            if(l.elem[i].ear == EarType::UNKNOWN) {
-                (l.elem[i]).ear = IsEar(i, scaledEps) ?
-                                        EarType::EAR : EarType::NOT_EAR;
-            }
+    // The vertices that remain form a doubly linked list, still in their
+    // original order, so that clipping an ear takes constant time; head is
+    // always the first of them.
+    int n = l.n, left = n, head = 0;
+    if(n < 3) return;
+    std::vector<int> prev(n), next(n);
+    for(i = 0; i < n; i++) {
+        prev[i] = WRAP(i-1, n);
+        next[i] = WRAP(i+1, n);
+    }
+
+    // On a plane, any ear is a good ear. We alternate between the first ear
+    // from the start of the list and the first from its last vertex, so we
+    // generate strip-like triangulations instead of fan-like; since the
+    // vertices stay in order, those come from a set of the ears' indices.
+    // On a curved surface, we clip the ear with the smallest chord tolerance
+    // from the surface (which we remember in auxv.x), from a heap. An entry
+    // in the heap is stale if that vertex was clipped or reevaluated since.
+    bool planar = (srf->degm == 1 && srf->degn == 1);
+    std::set<int> ears;
+    typedef std::pair<double, int> TolEar;
+    std::vector<TolEar> byTol;
+    auto updateEar = [&](int bp) {
+        UpdateEar(prev[bp], bp, next[bp], scaledEps, &pts, planar ? NULL : srf);
+        if(l.elem[bp].ear != EarType::EAR) {
+            ears.erase(bp);
+        } else if(planar) {
+            ears.insert(bp);
+        } else {
+            byTol.push_back({ l.elem[bp].auxv.x, bp });
+            std::push_heap(byTol.begin(), byTol.end(), std::greater<TolEar>());
         }
+    };
+    for(i = 0; i < n; i++) {
+        updateEar(i);
+    }
 
+    bool toggle = false;
+    while(left > 3) {
         int bestEar = -1;
-        double bestChordTol = VERY_POSITIVE;
-        // Alternate the starting position so we generate strip-like
-        // triangulations instead of fan-like
-        toggle = !toggle;
-        int offset = toggle ? -1 : 0;
-        for(i = 0; i < l.n; i++) {
-            int ear = WRAP(i+offset, l.n);
-            if(l.elem[ear].ear == EarType::EAR) {
-                if(srf->degm == 1 && srf->degn == 1) {
-                    // This is a plane; any ear is a good ear.
-                    bestEar = ear;
-                    break;
-                }
-                // If we are triangulating a curved surface, then try to
-                // clip ears that have a small chord tolerance from the
-                // surface.
-                Vector prev = l.elem[WRAP((i+offset-1), l.n)].p,
-                       next = l.elem[WRAP((i+offset+1), l.n)].p;
-                double tol = srf->ChordToleranceForEdge(prev, next);
-                if(tol < bestChordTol - scaledEps) {
-                    bestEar = ear;
-                    bestChordTol = tol;
-                }
-                if(bestChordTol < 0.1*SS.ChordTolMm()) {
-                    break;
-                }
+        if(planar) {
+            toggle = !toggle;
+            if(toggle && l.elem[prev[head]].ear == EarType::EAR) {
+                bestEar = prev[head];
+            } else if(!ears.empty()) {
+                bestEar = *ears.begin();
+            }
+        } else {
+            while(!byTol.empty()) {
+                TolEar te = byTol.front();
+                std::pop_heap(byTol.begin(), byTol.end(), std::greater<TolEar>());
+                byTol.pop_back();
+
+                SPoint *sp = &(l.elem[te.second]);
+                if(sp->tag || sp->ear != EarType::EAR) continue;
+                if(!EXACT(sp->auxv.x == te.first)) continue;
+                bestEar = te.second;
+                break;
             }
         }
         if(bestEar < 0) {
             dbp("couldn't find an ear! fail");
             return;
         }
-        ClipEarInto(m, bestEar, scaledEps);
+        pts.RemovePoint(l.elem[bestEar].p);
+
+        int ap = prev[bestEar], cp = next[bestEar];
+        ClipEarInto(m, ap, bestEar, cp, scaledEps);
+        l.elem[bestEar].tag = 1;
+        ears.erase(bestEar);
+        next[ap] = cp;
+        prev[cp] = ap;
+        if(bestEar == head) head = cp;
+        left--;
+
+        // By deleting the point at bestEar, we may change the ear-ness of
+        // the points on either side.
+        updateEar(ap);
+        updateEar(cp);
     }
 
-    ClipEarInto(m, 0, scaledEps); // add the last triangle
+    // add the last triangle
+    ClipEarInto(m, prev[head], head, next[head], scaledEps);
+}
+
+void SContour::UpdateEar(int ap, int bp, int cp, double scaledEps,
+                         const SEdgeGrid *pts, SSurface *srf)
+{
+    SPoint *sp = &(l.elem[bp]);
+    sp->ear = IsEar(ap, bp, cp, scaledEps, pts) ? EarType::EAR : EarType::NOT_EAR;
+    if(srf && sp->ear == EarType::EAR) {
+        sp->auxv.x = srf->ChordToleranceForEdge(l.elem[ap].p, l.elem[cp].p);
+    }
 }
 
 double SSurface::ChordToleranceForEdge(Vector a, Vector b) const {
@@ -388,22 +450,29 @@ void SSurface::MakeTriangulationGridInto(List<double> *l, double vs, double vf,
     double worst = 0;
 
     // Try piecewise linearizing four curves, at u = 0, 1/3, 2/3, 1; choose
-    // the worst chord tolerance of any of those.
-    int i;
+    // the worst chord tolerance of any of those. Evaluate all sixteen points
+    // that needs in one batch.
+    double vm1 = (2*vs + vf) / 3,
+           vm2 = (vs + 2*vf) / 3;
+    double vt[4] = { vs, vf, vm1, vm2 };
+    Point2d puv[16];
+    Vector pt[16];
+    int i, j;
     for(i = 0; i <= 3; i++) {
         double u = i/3.0;
+        for(j = 0; j < 4; j++) {
+            puv[4*i + j] = swapped ? Point2d::From(vt[j], u) :
+                                     Point2d::From(u, vt[j]);
+        }
+    }
+    PointsAt(puv, 16, pt);
 
+    for(i = 0; i <= 3; i++) {
         // This chord test should be identical to the one in SBezier::MakePwl
         // to make the piecewise linear edges line up with the grid more or
         // less.
-        Vector ps = PointAtMaybeSwapped(u, vs, swapped),
-               pf = PointAtMaybeSwapped(u, vf, swapped);
-
-        double vm1 = (2*vs + vf) / 3,
-               vm2 = (vs + 2*vf) / 3;
-
-        Vector pm1 = PointAtMaybeSwapped(u, vm1, swapped),
-               pm2 = PointAtMaybeSwapped(u, vm2, swapped);
+        Vector ps  = pt[4*i],     pf  = pt[4*i + 1],
+               pm1 = pt[4*i + 2], pm2 = pt[4*i + 3];
 
         worst = max(worst, pm1.DistanceToLine(ps, pf.Minus(ps)));
         worst = max(worst, pm2.DistanceToLine(ps, pf.Minus(ps)));
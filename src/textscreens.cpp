@@ -423,6 +423,13 @@ void TextWindow::ShowGroupInfo() {
         Printf(false, "possible to fix the problem by choosing ");
         Printf(false, "'force NURBS surfaces to triangle mesh'.");
     }
+    if(!g->clean && SS.lastGenerateCancelled) {
+        Printf(false, "");
+        Printf(false, "Regenerating the solid model took longer ");
+        Printf(false, "than the time limit, so the model shown ");
+        Printf(false, "for this group is out of date. Choose ");
+        Printf(false, "Edit -> Regenerate All to finish it.");
+    }
 
 list_items:
     Printf(false, "");
@@ -402,6 +402,7 @@ public:
         G_CODE_FEED           = 122,
         G_CODE_PLUNGE_FEED    = 123,
         AUTOSAVE_INTERVAL     = 124,
+        GENERATE_TIME_LIMIT   = 125,
         // For TTF text
         TTF_TEXT              = 300,
         // For the step dimension screen
@@ -554,6 +555,7 @@ public:
     static void ScreenChangeExportOffset(int link, uint32_t v);
     static void ScreenChangeGCodeParameter(int link, uint32_t v);
     static void ScreenChangeAutosaveInterval(int link, uint32_t v);
+    static void ScreenChangeGenerateTimeLimit(int link, uint32_t v);
     static void ScreenChangeStyleName(int link, uint32_t v);
     static void ScreenChangeStyleMetric(int link, uint32_t v);
     static void ScreenChangeStyleTextAngle(int link, uint32_t v);
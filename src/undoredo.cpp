@@ -63,11 +63,13 @@ void SolveSpaceUI::PushFromCurrentOnto(UndoStack *uk) {
         dest.runningMesh = {};
         dest.thisShell = {};
         dest.runningShell = {};
+        dest.shellMeshKey = 0;
         dest.displayMesh = {};
         dest.displayOutlines = {};
 
         dest.remap = {};
         src->remap.DeepCopyInto(&(dest.remap));
+        dest.remapCache = {};
 
         dest.impMesh = {};
         dest.impShell = {};
@@ -5,6 +5,8 @@
 // Copyright 2008-2013 Jonathan Westhues.
 //-----------------------------------------------------------------------------
 #include "solvespace.h"
+#include <condition_variable>
+#include <deque>
 
 using namespace SolveSpace;
 
@@ -94,6 +96,116 @@ void SolveSpace::MultMatrix(double *mata, double *matb, double *matr) {
     }
 }
 
+//-----------------------------------------------------------------------------
+// The threads behind ParallelFor. They're started the first time that we have
+// enough work to share, and then wait for jobs on the queue, so that a regen
+// that calls ParallelFor many times doesn't pay to create and join threads
+// for each call. The thread that queued a job works on it too, and doesn't
+// return until every claimed index is finished.
+//-----------------------------------------------------------------------------
+namespace {
+class WorkerPool {
+public:
+    struct Job {
+        const std::function<void(int)> *fn;
+        int                             n;
+        std::atomic<int>                next;
+        int                             active; // guarded by mutex
+    };
+
+    std::mutex                  mutex;
+    std::condition_variable     wake;
+    std::condition_variable     idle;
+    std::deque<Job *>           queue;
+    std::vector<std::thread>    threads;
+    bool                        stop = false;
+
+    static WorkerPool *Get() {
+        static WorkerPool pool;
+        return &pool;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for(std::thread &t : threads) {
+            t.join();
+        }
+    }
+
+    static void RunIndices(Job *job) {
+        for(;;) {
+            int i = job->next++;
+            if(i >= job->n) break;
+            (*job->fn)(i);
+        }
+    }
+
+    void WorkerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for(;;) {
+            wake.wait(lock, [&]() { return stop || !queue.empty(); });
+            if(stop) break;
+
+            Job *job = queue.front();
+            job->active++;
+            lock.unlock();
+            RunIndices(job);
+            lock.lock();
+            // Nothing left to claim, so nobody else should pick it up.
+            if(!queue.empty() && queue.front() == job) queue.pop_front();
+            if(--job->active == 0) idle.notify_all();
+        }
+    }
+
+    void Run(Job *job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(threads.empty()) {
+                int n = (int)std::thread::hardware_concurrency() - 1;
+                for(int i = 0; i < n; i++) {
+                    threads.emplace_back([this]() { WorkerLoop(); });
+                }
+            }
+            queue.push_back(job);
+        }
+        wake.notify_all();
+
+        RunIndices(job);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = std::find(queue.begin(), queue.end(), job);
+        if(it != queue.end()) queue.erase(it);
+        idle.wait(lock, [&]() { return job->active == 0; });
+    }
+};
+}
+
+//-----------------------------------------------------------------------------
+// Call fn(i) for every i in [0, n), spread across the available cores. The
+// calls happen in no particular order and on no particular thread, so fn must
+// write only to state that belongs to its own i; anything that has to happen
+// in order is up to the caller, once we return. A few items aren't worth
+// waking the pool for, so those just run here.
+//-----------------------------------------------------------------------------
+void SolveSpace::ParallelFor(int n, const std::function<void(int)> &fn) {
+    const int MIN_PARALLEL_ITEMS = 4;
+    if(n < MIN_PARALLEL_ITEMS || std::thread::hardware_concurrency() <= 1) {
+        for(int i = 0; i < n; i++) fn(i);
+        return;
+    }
+
+    WorkerPool::Job job;
+    job.fn     = &fn;
+    job.n      = n;
+    job.next   = 0;
+    job.active = 0;
+    WorkerPool::Get()->Run(&job);
+}
+
 //-----------------------------------------------------------------------------
 // Word-wrap the string for our message box appropriately, and then display
 // that string.
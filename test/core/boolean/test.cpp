@@ -0,0 +1,194 @@
+#include "harness.h"
+
+// The volume enclosed by a closed mesh, by the divergence theorem.
+static double VolumeOf(const SMesh *m) {
+    double vol = 0;
+    for(const STriangle &tr : m->l) {
+        vol += (tr.a).Dot((tr.b).Cross(tr.c)) / 6;
+    }
+    return fabs(vol);
+}
+
+static double VolumeOf(SShell *sh) {
+    SMesh m = {};
+    sh->TriangulateInto(&m);
+    double vol = VolumeOf(&m);
+    m.Clear();
+    return vol;
+}
+
+// The surfaces that weren't trimmed away entirely.
+static int SurfacesWithTrims(const SShell *sh) {
+    int n = 0;
+    for(const SSurface &ss : sh->surface) {
+        if(ss.trim.n > 0) n++;
+    }
+    return n;
+}
+
+// Extrude the closed curves in sbl from where they are by t, with the
+// loops oriented the way the extrude group would have them.
+static void ExtrudeInto(SShell *sh, SBezierList *sbl, Vector t) {
+    SBezierLoopSetSet sblss = {};
+    SPolygon poly = {};
+    SEdge errorAt = {};
+    Vector errorPt;
+    bool allClosed, allCoplanar;
+    sblss.FindOuterFacesFrom(sbl, &poly, NULL, SS.ChordTolMm(),
+                             &allClosed, &errorAt, &allCoplanar, &errorPt, NULL);
+    for(SBezierLoopSet &sbls : sblss.l) {
+        sh->MakeFromExtrusionOf(&sbls, Vector::From(0, 0, 0), t, RgbaColor::From(0, 0, 0));
+    }
+    sblss.Clear();
+    poly.Clear();
+    sbl->Clear();
+}
+
+// A cylinder of radius r, with one end centered on c, along axis.
+static void MakeCylinder(SShell *sh, Vector c, Vector axis, double r) {
+    Vector u = axis.Normal(0).WithMagnitude(r),
+           v = axis.Normal(1).WithMagnitude(r);
+    SBezierList sbl = {};
+    for(int i = 0; i < 4; i++) {
+        SBezier sb = SBezier::From(c.Plus(u), c.Plus(u).Plus(v), c.Plus(v));
+        sb.weight[1] = sqrt(0.5);
+        sbl.l.Add(&sb);
+        // and on to the next quadrant
+        Vector t = u;
+        u = v;
+        v = t.ScaledBy(-1);
+    }
+    ExtrudeInto(sh, &sbl, axis);
+}
+
+static void MakeBox(SShell *sh, Vector minp, Vector maxp) {
+    Vector p[4] = {
+        Vector::From(minp.x, minp.y, minp.z),
+        Vector::From(maxp.x, minp.y, minp.z),
+        Vector::From(maxp.x, maxp.y, minp.z),
+        Vector::From(minp.x, maxp.y, minp.z),
+    };
+    SBezierList sbl = {};
+    for(int i = 0; i < 4; i++) {
+        SBezier sb = SBezier::From(p[i], p[(i + 1) % 4]);
+        sbl.l.Add(&sb);
+    }
+    ExtrudeInto(sh, &sbl, Vector::From(0, 0, maxp.z - minp.z));
+}
+
+TEST_CASE(cylinders_equal_radius_tee) {
+    double tol = 0.01;
+    SS.chordTolCalculated = tol;
+
+    // A tee: the axes meet at the origin, so the cylinders intersect in
+    // halves of two ellipses, which touch where the cylinders are tangent.
+    double r = 5, la = 20, lb = 15;
+    SShell a = {}, b = {}, u = {};
+    MakeCylinder(&a, Vector::From(0, 0, -la/2), Vector::From(0, 0, la), r);
+    MakeCylinder(&b, Vector::From(0, 0, 0),     Vector::From(lb, 0, 0), r);
+    u.MakeFromBoolean(&a, &b, SSurface::CombineAs::UNION);
+    CHECK_FALSE(u.booleanFailed);
+
+    // Those come out as exact conics, not marched; one for each quarter of
+    // a circle of b, since the quadrants of the two cylinders line up here.
+    int exactConics = 0, marched = 0;
+    for(const SCurve &sc : u.curve) {
+        if(sc.source != SCurve::Source::INTERSECTION) continue;
+        if(!sc.isExact) {
+            marched++;
+        } else if(sc.exact.deg == 2) {
+            exactConics++;
+        }
+    }
+    CHECK_TRUE(exactConics == 4);
+    CHECK_TRUE(marched == 0);
+
+    // The part of b within a is half of a Steinmetz solid. Every point on
+    // the triangulated surface is within the chord tolerance of the exact
+    // one, so the volumes differ by at most that times the area, which is
+    // no more than the area of both cylinders.
+    double vol  = PI*r*r*la + PI*r*r*lb - (16.0/3)*r*r*r/2,
+           area = 2*PI*r*(la + lb) + 4*PI*r*r;
+    CHECK_TRUE(fabs(VolumeOf(&u) - vol) < area*tol);
+
+    a.Clear();
+    b.Clear();
+    u.Clear();
+}
+
+TEST_CASE(box_far_surfaces) {
+    SS.chordTolCalculated = 0.01;
+
+    // The far faces of each box are nowhere near the other box, so those
+    // are kept or dropped whole, without trimming.
+    SShell a = {}, b = {}, u = {}, d = {};
+    MakeBox(&a, Vector::From(0, 0, 0), Vector::From(10, 10, 10));
+    MakeBox(&b, Vector::From(5, 2, 2), Vector::From(15, 8, 8));
+
+    u.MakeFromBoolean(&a, &b, SSurface::CombineAs::UNION);
+    CHECK_FALSE(u.booleanFailed);
+    CHECK_EQ_EPS(VolumeOf(&u), 1000 + 360 - 180);
+
+    d.MakeFromBoolean(&a, &b, SSurface::CombineAs::DIFFERENCE);
+    CHECK_FALSE(d.booleanFailed);
+    CHECK_EQ_EPS(VolumeOf(&d), 1000 - 180);
+
+    a.Clear();
+    b.Clear();
+    u.Clear();
+    d.Clear();
+}
+
+TEST_CASE(box_disjoint) {
+    SS.chordTolCalculated = 0.01;
+
+    // Every surface of each is far from the other shell.
+    SShell a = {}, b = {}, u = {}, d = {};
+    MakeBox(&a, Vector::From(0, 0, 0),       Vector::From(10, 10, 10));
+    MakeBox(&b, Vector::From(100, 0, 0),     Vector::From(110, 10, 10));
+
+    u.MakeFromBoolean(&a, &b, SSurface::CombineAs::UNION);
+    CHECK_FALSE(u.booleanFailed);
+    CHECK_TRUE(SurfacesWithTrims(&u) == 12);
+    CHECK_EQ_EPS(VolumeOf(&u), 2000);
+
+    d.MakeFromBoolean(&a, &b, SSurface::CombineAs::DIFFERENCE);
+    CHECK_FALSE(d.booleanFailed);
+    CHECK_TRUE(SurfacesWithTrims(&d) == 6);
+    CHECK_EQ_EPS(VolumeOf(&d), 1000);
+
+    a.Clear();
+    b.Clear();
+    u.Clear();
+    d.Clear();
+}
+
+TEST_CASE(mesh_disjoint_parts) {
+    SS.chordTolCalculated = 0.01;
+
+    // The mesh Boolean, with an operand in two parts: one that overlaps
+    // the other operand, and one that's entirely outside its box.
+    SShell a = {}, b1 = {}, b2 = {};
+    MakeBox(&a,  Vector::From(0, 0, 0),     Vector::From(10, 10, 10));
+    MakeBox(&b1, Vector::From(5, 2, 2),     Vector::From(15, 8, 8));
+    MakeBox(&b2, Vector::From(100, 0, 0),   Vector::From(110, 10, 10));
+
+    SMesh ma = {}, mb = {}, u = {}, d = {};
+    a.TriangulateInto(&ma);
+    b1.TriangulateInto(&mb);
+    b2.TriangulateInto(&mb);
+
+    u.MakeFromUnionOf(&ma, &mb);
+    CHECK_EQ_EPS(VolumeOf(&u), 1000 + 360 - 180 + 1000);
+
+    d.MakeFromDifferenceOf(&ma, &mb);
+    CHECK_EQ_EPS(VolumeOf(&d), 1000 - 180);
+
+    a.Clear();
+    b1.Clear();
+    b2.Clear();
+    ma.Clear();
+    mb.Clear();
+    u.Clear();
+    d.Clear();
+}